@@ -26,6 +26,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "utils/ParseUtils.h"
 #include "core/SolverTypes.h"
 #include "mtl/Matrix.h"
+#include "cosy/SymmetryController.h"
 
 namespace Glucose {
 
@@ -231,6 +232,50 @@ static void parse_SYMMETRY(gzFile input_stream, Solver& S, bool linear_sym_gens)
     StreamBuffer in(input_stream);
     parse_SYMMETRY_main(in, S, linear_sym_gens); }
 
+// Adds the swaps of the interchangeable rows detected by a symmetry controller (see
+// cosy::Interchangeability) as generators, as for the matrices of a BreakID file. Returns their number.
+template<class Solver>
+static int add_ROW_SWAPS(cosy::SymmetryController<Lit>& symmetry, Solver& S, bool linear_sym_gens) {
+    vec<Lit> from;
+    vec<Lit> to;
+    int      cnt = 0;
+    for (const std::pair<std::vector<Lit>, std::vector<Lit>>& swap : symmetry.rowSwaps(linear_sym_gens)) {
+        from.clear(); to.clear();
+        for (Lit l : swap.first)  from.push(l);
+        for (Lit l : swap.second) to.push(l);
+        S.addGenerator(new SymGenerator(from,to));
+        cnt++;
+    }
+    S.initiateGenWatches();
+    return cnt;
+}
+
+//=================================================================================================
+// Static symmetry breaking:
+
+// Adds the lex-leader clauses of the generators known by a symmetry controller as original clauses
+// (see cosy::LexLeader), after the auxiliary variables they use. Returns the number of clauses.
+template<class Solver>
+static int add_LEXLEADER(cosy::SymmetryController<Lit>& symmetry, Solver& S, cosy::OrderMode order, unsigned int budget) {
+    if ((unsigned int)S.nVars() > symmetry.numberOfVariables()) {
+        fprintf(stderr, "WARNING! Lex-leader clauses not added: the symmetries do not cover all the variables.\n");
+        return 0;
+    }
+    unsigned int nbAuxiliaries = symmetry.generateLexLeader(order, cosy::ValueMode::TRUE_LESS_FALSE, budget);
+    while ((unsigned int)S.nVars() < symmetry.numberOfVariables() + nbAuxiliaries) S.newVar();
+
+    vec<Lit> lits;
+    int      cnt = 0;
+    while (symmetry.hasClauseToInject(cosy::ClauseInjector::LEX_LEADER)) {
+        std::vector<Lit> clause = symmetry.clauseToInject(cosy::ClauseInjector::LEX_LEADER);
+        lits.clear();
+        for (Lit l : clause) lits.push(l);
+        cnt++;
+        S.addClause_(lits);
+    }
+    return cnt;
+}
+
 //=================================================================================================
 }
 
@@ -0,0 +1,98 @@
+/**********************************************************************************[ModelWriter.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "core/ModelWriter.h"
+
+#include <string.h>
+
+#include "mtl/XAlloc.h"
+
+using namespace Glucose;
+
+ModelWriter::ModelWriter(FILE* o, int buffer_size) : out(o), size(0), cap(buffer_size)
+{
+    assert(cap >= 64);
+    buf = (char*)xrealloc(NULL, cap);
+}
+
+ModelWriter::~ModelWriter()
+{
+    flush();
+    free(buf);
+}
+
+bool ModelWriter::parseFormat(const char* name, Format& format)
+{
+    if      (strcmp(name, "text")   == 0) format = Text;
+    else if (strcmp(name, "binary") == 0) format = Binary;
+    else if (strcmp(name, "bitset") == 0) format = Bitset;
+    else return false;
+    return true;
+}
+
+void ModelWriter::flush()
+{
+    if (size > 0)
+        fwrite(buf, 1, size, out);
+    size = 0;
+}
+
+void ModelWriter::putInt(int x)
+{
+    char     digits[12];
+    int      n = 0;
+    unsigned u = x < 0 ? -(unsigned)x : x;
+    do { digits[n++] = '0' + u % 10; u /= 10; } while (u > 0);
+    reserve(n + 1);
+    if (x < 0) buf[size++] = '-';
+    while (n > 0) buf[size++] = digits[--n];
+}
+
+void ModelWriter::putInt32(int x)
+{
+    uint32_t u = x;
+    reserve(4);
+    for (int i = 0; i < 4; i++, u >>= 8)
+        buf[size++] = (char)(u & 0xff);
+}
+
+void ModelWriter::write(const vec<lbool>& model, int nvars, Format format, const char* prefix)
+{
+    if (nvars > model.size()) nvars = model.size();
+    if (format == Bitset){
+        for (int i = 0; i < nvars; i += 8){
+            unsigned char byte = 0;
+            for (int j = 0; j < 8 && i + j < nvars; j++)
+                if (model[i + j] == l_True) byte |= 1 << j;
+            putChar(byte);
+        }
+    }else if (format == Binary){
+        for (int i = 0; i < nvars; i++)
+            if (model[i] != l_Undef)
+                putInt32(model[i] == l_True ? i + 1 : -(i + 1));
+        putInt32(0);
+    }else{
+        // Same layout as the former printf loop: no separator before the first variable only
+        for (const char* p = prefix; *p; p++) putChar(*p);
+        for (int i = 0; i < nvars; i++)
+            if (model[i] != l_Undef){
+                if (i != 0) putChar(' ');
+                putInt(model[i] == l_True ? i + 1 : -(i + 1)); }
+        for (const char* p = " 0\n"; *p; p++) putChar(*p);
+    }
+    flush();
+}
@@ -0,0 +1,71 @@
+/***********************************************************************************[ModelWriter.h]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_ModelWriter_h
+#define Glucose_ModelWriter_h
+
+#include <stdio.h>
+
+#include "mtl/Vec.h"
+#include "core/SolverTypes.h"
+
+namespace Glucose {
+
+//=================================================================================================
+// Writes a model through one large buffer, the integers being formatted by hand: a model of
+// millions of variables costs about the time of its bytes, instead of one printf per variable.
+//
+// Formats (see parseFormat):
+//   Text    "-1 2 -3 ... 0\n", the variables without value are skipped (after an optional prefix)
+//   Binary  the same literals as little endian 32 bits integers, ended by a 0
+//   Bitset  one bit per variable, set if it is true: bit i%8 of byte i/8 is the variable i+1
+//
+// Only the first 'nvars' variables of the model are written: the variables of the input formula,
+// without the auxiliary variables added by the solver (lex-leader constraints).
+
+class ModelWriter {
+public:
+    enum Format { Text, Binary, Bitset };
+
+    explicit ModelWriter(FILE* out, int buffer_size = 1 << 20);
+    ~ModelWriter();                  // Flushes, but does not close 'out'
+
+    // Returns false if 'name' is not "text", "binary" or "bitset"
+    static bool parseFormat(const char* name, Format& format);
+
+    void write(const vec<lbool>& model, int nvars, Format format, const char* prefix = "");
+    void flush();
+
+private:
+    FILE* out;
+    char* buf;
+    int   size;
+    int   cap;
+
+    void  reserve (int n) { if (size + n > cap) flush(); }
+    void  putChar (char c) { reserve(1); buf[size++] = c; }
+    void  putInt  (int x);
+    void  putInt32(int x);
+
+    ModelWriter(const ModelWriter&);
+    ModelWriter& operator=(const ModelWriter&);
+};
+
+//=================================================================================================
+}
+
+#endif
@@ -73,6 +73,7 @@ static DoubleOption opt_K(_cr, "K", "The constant used to force restart", 0.8, D
 static DoubleOption opt_R(_cr, "R", "The constant used to block restart", 1.4, DoubleRange(1, false, 5, false));
 static IntOption opt_size_lbd_queue(_cr, "szLBDQueue", "The size of moving average for LBD (restarts)", 50, IntRange(10, INT32_MAX));
 static IntOption opt_size_trail_queue(_cr, "szTrailQueue", "The size of moving average for trail (block restarts)", 5000, IntRange(10, INT32_MAX));
+static BoolOption opt_reuse_trail(_cr, "reuse-trail", "Keep the decision levels that would be picked again after a restart", true);
 
 static IntOption opt_first_reduce_db(_cred, "firstReduceDB", "The number of conflicts before the first reduce DB", 2000, IntRange(0, INT32_MAX));
 static IntOption opt_inc_reduce_db(_cred, "incReduceDB", "Increment for reduce DB", 300, IntRange(0, INT32_MAX));
@@ -81,6 +82,7 @@ static IntOption opt_lb_lbd_frozen_clause(_cred, "minLBDFrozenClause", "Protect
 
 static IntOption opt_lb_size_minimzing_clause(_cm, "minSizeMinimizingClause", "The min size required to minimize clause", 30, IntRange(3, INT32_MAX));
 static IntOption opt_lb_lbd_minimzing_clause(_cm, "minLBDMinimizingClause", "The min LBD required to minimize clause", 6, IntRange(3, INT32_MAX));
+static IntOption opt_lb_lbd_keep_esbp(_cred, "maxLBDKeepESBP", "Keep an ESBP conflict clause as a learnt clause if its LBD is at most (0: never)", 6, IntRange(0, INT32_MAX));
 
 
 static DoubleOption opt_var_decay(_cat, "var-decay", "The variable activity decay factor (starting point)", 0.8, DoubleRange(0, false, 1, false));
@@ -91,6 +93,9 @@ static DoubleOption opt_random_seed(_cat, "rnd-seed", "Used by the random variab
 static IntOption opt_ccmin_mode(_cat, "ccmin-mode", "Controls conflict clause minimization (0=none, 1=basic, 2=deep)", 2, IntRange(0, 2));
 static IntOption opt_phase_saving(_cat, "phase-saving", "Controls the level of phase saving (0=none, 1=limited, 2=full)", 2, IntRange(0, 2));
 static BoolOption opt_rnd_init_act(_cat, "rnd-init", "Randomize the initial activity", false);
+static BoolOption opt_lazy_sel_reasons(_cat, "lazy-sel-reasons", "Attach the SEL clauses propagating a literal only if they take part in a conflict", true);
+static BoolOption opt_ternary_watches(_cat, "ternary-watches", "Watch the ternary clauses in a dedicated list holding their literals", true);
+static BoolOption opt_minimize_esbp(_cat, "minimize-esbp", "Remove the root level and self-subsumed literals of the ESBP conflict clauses", true);
 static DoubleOption opt_garbage_frac(_cat, "gc-frac", "The fraction of wasted memory allowed before a garbage collection is triggered", 0.20, DoubleRange(0, false, HUGE_VAL, false));
 
 
@@ -107,12 +112,14 @@ verbosity(0)
 , R(opt_R)
 , sizeLBDQueue(opt_size_lbd_queue)
 , sizeTrailQueue(opt_size_trail_queue)
+, reuseTrail(opt_reuse_trail)
 , firstReduceDB(opt_first_reduce_db)
 , incReduceDB(opt_inc_reduce_db)
 , specialIncReduceDB(opt_spec_inc_reduce_db)
 , lbLBDFrozenClause(opt_lb_lbd_frozen_clause)
 , lbSizeMinimizingClause(opt_lb_size_minimzing_clause)
 , lbLBDMinimizingClause(opt_lb_lbd_minimzing_clause)
+, lbLBDKeepESBP(opt_lb_lbd_keep_esbp)
 , var_decay(opt_var_decay)
 , max_var_decay(opt_max_var_decay)
 , clause_decay(opt_clause_decay)
@@ -127,7 +134,9 @@ verbosity(0)
 , certifiedUNSAT(false) // Not in the first parallel version
 , panicModeLastRemoved(0), panicModeLastRemovedShared(0)
 , useUnaryWatched(false)
+, useTernaryWatches(opt_ternary_watches)
 , promoteOneWatchedClause(true)
+, nextImportConflicts(UINT64_MAX)
 // Statistics: (formerly in 'SolverStats')
 //
 , nbPromoted(0)
@@ -137,6 +146,8 @@ verbosity(0)
 , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0), conflictsRestarts(0)
 , nbstopsrestarts(0), nbstopsrestartssame(0), lastblockatrestart(0)
 , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+, nbReusedTrails(0), nbReusedLevels(0)
+, nbReducedLits(0)
 , curRestart(1)
 , ok(true)
 , cla_inc(1)
@@ -144,6 +155,7 @@ verbosity(0)
 , watches(WatcherDeleted(ca))
 , watchesBin(WatcherDeleted(ca))
 , unaryWatches(WatcherDeleted(ca))
+, watchesTer(TernaryWatcherDeleted(ca))
 , qhead(0)
 , simpDB_assigns(-1)
 , simpDB_props(0)
@@ -153,10 +165,15 @@ verbosity(0)
 , reduceOnSize(false) //
 , reduceOnSizeSize(12) // Constant to use on size reductions
 ,lastLearntClause(CRef_Undef)
+,pendingESBP(CRef_Undef)
 // Resource constraints:
 //
 , conflict_budget(-1)
 , propagation_budget(-1)
+, time_budget(-1)
+, memory_budget(-1)
+, budget_checks(0)
+, budget_exhausted(false)
 , asynch_interrupt(false)
 , incremental(false)
 , nbVarsInitialFormula(INT32_MAX)
@@ -167,12 +184,24 @@ verbosity(0)
 , qhead_gen(0)
 , watchidx(0)
 , qhead_sel(0)
+, selWatched(false)
 , symgenprops(0)
 , symgenconfls(0)
 , symselprops(0)
 , symselconfls(0)
+, symselkept(0)
+, symesbpconfls(0)
+, symesbpkept(0)
+, symesbplits(0)
+, metrics(NULL)
+, metricsMemoryTime(0)
 {
     MYFLAG = 0;
+    binResFlag = 0;
+    useSEL = true;
+    lazySELReasons = opt_lazy_sel_reasons;
+    minimizeESBP = opt_minimize_esbp;
+    esbpOrder = cosy::OrderMode::AUTO;
     // Initialize only first time. Useful for incremental solving (not in // version), useless otherwise
     // Kept here for simplicity
     lbdQueue.initSize(sizeLBDQueue);
@@ -186,7 +215,6 @@ verbosity(0)
 //-------------------------------------------------------
 // Special constructor used for cloning solvers
 //-------------------------------------------------------
-// TODO: clone symmetry attributes?
 Solver::Solver(const Solver &s) :
   verbosity(s.verbosity)
 , showModel(s.showModel)
@@ -194,12 +222,14 @@ Solver::Solver(const Solver &s) :
 , R(s.R)
 , sizeLBDQueue(s.sizeLBDQueue)
 , sizeTrailQueue(s.sizeTrailQueue)
+, reuseTrail(s.reuseTrail)
 , firstReduceDB(s.firstReduceDB)
 , incReduceDB(s.incReduceDB)
 , specialIncReduceDB(s.specialIncReduceDB)
 , lbLBDFrozenClause(s.lbLBDFrozenClause)
 , lbSizeMinimizingClause(s.lbSizeMinimizingClause)
 , lbLBDMinimizingClause(s.lbLBDMinimizingClause)
+, lbLBDKeepESBP(s.lbLBDKeepESBP)
 , var_decay(s.var_decay)
 , max_var_decay(s.max_var_decay)
 , clause_decay(s.clause_decay)
@@ -214,7 +244,9 @@ Solver::Solver(const Solver &s) :
 , certifiedUNSAT(false) // Not in the first parallel version
 , panicModeLastRemoved(s.panicModeLastRemoved), panicModeLastRemovedShared(s.panicModeLastRemovedShared)
 , useUnaryWatched(s.useUnaryWatched)
+, useTernaryWatches(s.useTernaryWatches)
 , promoteOneWatchedClause(s.promoteOneWatchedClause)
+, nextImportConflicts(s.nextImportConflicts)
 // Statistics: (formerly in 'SolverStats')
 //
 , nbPromoted(s.nbPromoted)
@@ -228,6 +260,8 @@ Solver::Solver(const Solver &s) :
 , lastblockatrestart(s.lastblockatrestart)
 , dec_vars(s.dec_vars), clauses_literals(s.clauses_literals)
 , learnts_literals(s.learnts_literals), max_literals(s.max_literals), tot_literals(s.tot_literals)
+, nbReusedTrails(s.nbReusedTrails), nbReusedLevels(s.nbReusedLevels)
+, nbReducedLits(s.nbReducedLits)
 , curRestart(s.curRestart)
 
 , ok(true)
@@ -236,6 +270,7 @@ Solver::Solver(const Solver &s) :
 , watches(WatcherDeleted(ca))
 , watchesBin(WatcherDeleted(ca))
 , unaryWatches(WatcherDeleted(ca))
+, watchesTer(TernaryWatcherDeleted(ca))
 , qhead(s.qhead)
 , simpDB_assigns(s.simpDB_assigns)
 , simpDB_props(s.simpDB_props)
@@ -245,10 +280,15 @@ Solver::Solver(const Solver &s) :
 , reduceOnSize(s.reduceOnSize) //
 , reduceOnSizeSize(s.reduceOnSizeSize) // Constant to use on size reductions
 ,lastLearntClause(CRef_Undef)
+,pendingESBP(CRef_Undef)
 // Resource constraints:
 //
 , conflict_budget(s.conflict_budget)
 , propagation_budget(s.propagation_budget)
+, time_budget(s.time_budget)
+, memory_budget(s.memory_budget)
+, budget_checks(0)
+, budget_exhausted(s.budget_exhausted)
 , asynch_interrupt(s.asynch_interrupt)
 , incremental(s.incremental)
 , nbVarsInitialFormula(s.nbVarsInitialFormula)
@@ -256,6 +296,20 @@ Solver::Solver(const Solver &s) :
 , totalTime4Unsat(s.totalTime4Unsat)
 , nbSatCalls(s.nbSatCalls)
 , nbUnsatCalls(s.nbUnsatCalls)
+, qhead_gen(s.qhead_gen)
+, watchidx(0)
+, qhead_sel(s.qhead_sel)
+, selWatched(s.selWatched)
+, symgenprops(s.symgenprops)
+, symgenconfls(s.symgenconfls)
+, symselprops(s.symselprops)
+, symselconfls(s.symselconfls)
+, symselkept(s.symselkept)
+, symesbpconfls(s.symesbpconfls)
+, symesbpkept(s.symesbpkept)
+, symesbplits(s.symesbplits)
+, metrics(NULL)
+, metricsMemoryTime(0)
 {
     // Copy clauses.
     s.ca.copyTo(ca);
@@ -263,6 +317,11 @@ Solver::Solver(const Solver &s) :
 
     // Initialize  other variables
      MYFLAG = 0;
+    binResFlag = 0;
+    useSEL = s.useSEL;
+    lazySELReasons = s.lazySELReasons;
+    minimizeESBP = s.minimizeESBP;
+    esbpOrder = s.esbpOrder;
     // Initialize only first time. Useful for incremental solving (not in // version), useless otherwise
     // Kept here for simplicity
     sumLBD = s.sumLBD;
@@ -272,11 +331,13 @@ Solver::Solver(const Solver &s) :
     s.watches.copyTo(watches);
     s.watchesBin.copyTo(watchesBin);
     s.unaryWatches.copyTo(unaryWatches);
+    s.watchesTer.copyTo(watchesTer);
     s.assigns.memCopyTo(assigns);
     s.vardata.memCopyTo(vardata);
     s.activity.memCopyTo(activity);
     s.seen.memCopyTo(seen);
     s.permDiff.memCopyTo(permDiff);
+    binResStamp.growTo(s.binResStamp.size(), 0);
     s.polarity.memCopyTo(polarity);
     s.decision.memCopyTo(decision);
     s.trail.memCopyTo(trail);
@@ -287,15 +348,20 @@ Solver::Solver(const Solver &s) :
     s.lbdQueue.copyTo(lbdQueue);
     s.trailQueue.copyTo(trailQueue);
 
+    // Symmetry: generators are duplicated since the compatibility sets of the clauses point
+    // to the generators of their own solver. The symmetry controller (ESBP) is not cloned.
+    // Clones are made before the search: there is no SEL clause nor ESBP clause to copy.
+    for (int i = 0; i < s.generators.size(); i++)
+        generators.push(new SymGenerator(*s.generators[i]));
+    initiateGenWatches();
+    selClauseWatches.growTo(s.selClauseWatches.size());
+    selIdx.push(0);
 }
 
 Solver::~Solver() {
     for(int i=0; i<generators.size(); ++i){
         delete generators[i];
     }
-    for(int i=0; i<selClauseWatches.size(); ++i){
-        delete selClauseWatches[i];
-    }
 }
 
 /****************************************************************
@@ -306,7 +372,9 @@ Solver::~Solver() {
 // You can add special code for this mode here.
 
 void Solver::setIncrementalMode() {
+  assert(nClauses() == 0);
   incremental = true;
+  useTernaryWatches = false; // The watches of clauses with selectors are chosen in propagate
 }
 
 // Number of variables without selectors
@@ -319,6 +387,36 @@ bool Solver::isIncremental() {
 }
 
 
+//=================================================================================================
+// Resource budgets:
+
+
+void Solver::setTimeBudget(double x) {
+    time_budget      = realTime() + x;
+    budget_exhausted = false;
+}
+
+void Solver::setMemBudget(double x) {
+    memory_budget    = x;
+    budget_exhausted = false;
+}
+
+// withinBudget is checked at each decision of the search (and for each variable of the elimination):
+// the clock is read every 64 checks, the memory (a read of /proc) every 4096 checks.
+bool Solver::withinResourceBudget() const {
+    if (budget_exhausted)
+        return false;
+    uint64_t n = budget_checks++;
+    if ((n & 63) != 0)
+        return true;
+    if (time_budget >= 0 && realTime() > time_budget)
+        budget_exhausted = true;
+    else if (memory_budget >= 0 && (n & 4095) == 0 && memUsed() > memory_budget)
+        budget_exhausted = true;
+    return !budget_exhausted;
+}
+
+
 //=================================================================================================
 // Minor methods:
 
@@ -335,17 +433,21 @@ Var Solver::newVar(bool sign, bool dvar) {
     watchesBin .init(mkLit(v, true));
     unaryWatches .init(mkLit(v, false));
     unaryWatches .init(mkLit(v, true));
+    watchesTer .init(mkLit(v, false));
+    watchesTer .init(mkLit(v, true));
     assigns .push(l_Undef);
     vardata .push(mkVarData(CRef_Undef, 0));
     activity .push(rnd_init_act ? drand(random_seed) * 0.00001 : 0);
     seen .push(0);
     permDiff .push(0);
+    binResStamp .push(0);
+    binResStamp .push(0);
     polarity .push(sign);
     decision .push();
     trail .capacity(v + 1);
     setDecisionVar(v, dvar);
-    selClauseWatches.push(new vec<int>());
-    selClauseWatches.push(new vec<int>());
+    selClauseWatches.push();
+    selClauseWatches.push();
     genWatchIndices.push(genWatches.size());
     return v;
 }
@@ -411,6 +513,10 @@ void Solver::attachClause(CRef cr) {
     if (c.size() == 2) {
         watchesBin[~c[0]].push(Watcher(cr, c[1]));
         watchesBin[~c[1]].push(Watcher(cr, c[0]));
+    } else if (c.size() == 3 && useTernaryWatches) {
+        watchesTer[~c[0]].push(TernaryWatcher(cr, c[1], c[2]));
+        watchesTer[~c[1]].push(TernaryWatcher(cr, c[0], c[2]));
+        watchesTer[~c[2]].push(TernaryWatcher(cr, c[0], c[1]));
     } else {
         watches[~c[0]].push(Watcher(cr, c[1]));
         watches[~c[1]].push(Watcher(cr, c[0]));
@@ -440,6 +546,16 @@ void Solver::detachClause(CRef cr, bool strict) {
             watchesBin.smudge(~c[0]);
             watchesBin.smudge(~c[1]);
         }
+    } else if (c.size() == 3 && useTernaryWatches) {
+        if (strict) {
+            remove(watchesTer[~c[0]], TernaryWatcher(cr, c[1], c[2]));
+            remove(watchesTer[~c[1]], TernaryWatcher(cr, c[0], c[2]));
+            remove(watchesTer[~c[2]], TernaryWatcher(cr, c[0], c[1]));
+        } else {
+            watchesTer.smudge(~c[0]);
+            watchesTer.smudge(~c[1]);
+            watchesTer.smudge(~c[2]);
+        }
     } else {
         if (strict) {
             remove(watches[~c[0]], Watcher(cr, c[1]));
@@ -572,45 +688,41 @@ inline unsigned int Solver::computeLBD(const Clause &c) {
 /******************************************************************
  * Minimisation with binary reolution
  ******************************************************************/
-void Solver::minimisationWithBinaryResolution(vec<Lit> &out_learnt) {
-    return;
-    // Find the LBD measure
-    unsigned int lbd = computeLBD(out_learnt);
-    Lit p = ~out_learnt[0];
-
-    if (lbd <= lbLBDMinimizingClause) {
-        MYFLAG++;
-
-        for (int i = 1; i < out_learnt.size(); i++) {
-            permDiff[var(out_learnt[i])] = MYFLAG;
-        }
-
-        vec<Watcher>& wbin = watchesBin[p];
-        int nb = 0;
-        for (int k = 0; k < wbin.size(); k++) {
-            Lit imp = wbin[k].blocker;
-            if (permDiff[var(imp)] == MYFLAG && value(imp) == l_True) {
-                nb++;
-                permDiff[var(imp)] = MYFLAG - 1;
-            }
-        }
-        int l = out_learnt.size() - 1;
-        if (nb > 0) {
-            nbReducedClauses++;
-            for (int i = 1; i < out_learnt.size() - nb; i++) {
-                if (permDiff[var(out_learnt[i])] != MYFLAG) {
-                    Lit p = out_learnt[l];
-                    out_learnt[l] = out_learnt[i];
-                    out_learnt[i] = p;
-                    l--;
-                    i--;
-                }
-            }
-
-            out_learnt.shrink(nb);
-
+// Removes every literal l of c (but c[0]) such that the binary clause (c[0] v ~l) exists:
+// resolving it with c on l gives c \ {l}. Binary clauses derived from ESBP are not used, so
+// the symmetry flags of c remain valid. Nothing is removed if less than minSize literals
+// would remain (a unit derived from ESBP would need to be flagged with setESBPUnit).
+int Solver::minimisationWithBinaryResolution(vec<Lit> &c, int minSize) {
+    if (binResFlag >= UINT32_MAX - 2) { // Stamps overflow
+        for (int i = 0; i < binResStamp.size(); i++) binResStamp[i] = 0;
+        binResFlag = 0;
+    }
+    binResFlag += 2;
+    const unsigned int inClause = binResFlag, removed = binResFlag + 1;
+
+    for (int i = 1; i < c.size(); i++)
+        binResStamp[toInt(~c[i])] = inClause;
+
+    vec<Watcher>& wbin = watchesBin[~c[0]];
+    int nb = 0;
+    for (int k = 0; k < wbin.size(); k++) {
+        Lit imp = wbin[k].blocker;
+        if (binResStamp[toInt(imp)] == inClause && !ca[wbin[k].cref].symmetry()) {
+            nb++;
+            binResStamp[toInt(imp)] = removed;
         }
     }
+    if (nb == 0 || c.size() - nb < minSize)
+        return 0;
+
+    int i, j;
+    for (i = j = 1; i < c.size(); i++)
+        if (binResStamp[toInt(~c[i])] != removed)
+            c[j++] = c[i];
+    c.shrink(i - j);
+    nbReducedClauses++;
+    nbReducedLits += nb;
+    return nb;
 }
 
 // Revert to the state at given level (keeping all assignment at 'level' but not beyond).
@@ -618,6 +730,13 @@ void Solver::minimisationWithBinaryResolution(vec<Lit> &out_learnt) {
 
 void Solver::cancelUntil(int lvl) {
     if (decisionLevel() > lvl) {
+        // SEL reasons that did not take part in a conflict are not needed anymore
+        while (selLazyReasons.size() > 0 && level(selLazyReasons.last()) > lvl) {
+            CRef cr = reason(selLazyReasons.last());
+            if (ca[cr].lazyReason())
+                ca.free(cr);
+            selLazyReasons.pop();
+        }
         for (int c = trail.size() - 1; c >= trail_lim[lvl]; c--) {
             Var x = var(trail[c]);
             assigns [x] = l_Undef;
@@ -636,8 +755,11 @@ void Solver::cancelUntil(int lvl) {
         trail.shrink(trail.size() - trail_lim[lvl]);
         trail_lim.shrink(trail_lim.size() - lvl);
         if(lvl==0){
-            for(int i=0; i<selClauseWatches.size(); ++i){
-                selClauseWatches[i]->clear();
+            if(selWatched){
+                for(int i=0; i<selClauseWatches.size(); ++i){
+                    selClauseWatches[i].clear();
+                }
+                selWatched = false;
             }
             selClauses.clear();
             selIdx.clear(); selIdx.push(0);
@@ -655,6 +777,34 @@ void Solver::cancelUntil(int lvl) {
     }
 }
 
+/*_________________________________________________________________________________________________
+|
+|  reusableTrailLevel : ()  ->  [int]
+|
+|  Description:
+|    Trail reuse on restart (van der Tak, Ramos & Heule, 2011). After a restart, the solver would
+|    pick again every decision whose variable is more active than the best unassigned variable.
+|    These decision levels are kept: their propagations, the SEL clauses and the cosy lookup
+|    states they built do not need to be computed again.
+|________________________________________________________________________________________________@*/
+int Solver::reusableTrailLevel() {
+    Var next = var_Undef;
+    while (!order_heap.empty()) {
+        next = order_heap[0];
+        if (value(next) == l_Undef && decision[next])
+            break;
+        order_heap.removeMin(); // Assigned variables are put back by cancelUntil
+        next = var_Undef;
+    }
+    if (next == var_Undef)
+        return decisionLevel();
+
+    int lvl = 0;
+    while (lvl < decisionLevel() && activity[var(trail[trail_lim[lvl]])] > activity[next])
+        lvl++;
+    return lvl;
+}
+
 
 //=================================================================================================
 // Major methods:
@@ -722,6 +872,13 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt,vec<Lit>&selectors, int& o
             c[0] = c[1], c[1] = tmp;
         }
 
+        if (c.lazyReason()) { // SEL reason taking part in the conflict: keep it
+            c.setLazyReason(false);
+            learnts.push(confl);
+            attachClause(confl);
+            symselkept++;
+        }
+
         if (c.symmetry()) {
             isSymmetry = true;
             symmetries.push_back(ca[confl].scompat());
@@ -753,7 +910,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt,vec<Lit>&selectors, int& o
         for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++) {
             Lit q = c[j];
 
-            if (level(var(q)) == 0 && forbid_units.find(var(q)) != forbid_units.end()) {
+            if (level(var(q)) == 0 && isESBPUnit(var(q))) {
                 isSymmetry = true;
             }
 
@@ -836,9 +993,9 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt,vec<Lit>&selectors, int& o
       Then, we reduce clauses with small LBD.
       Otherwise, this can be useless
      */
-    // if (!incremental && out_learnt.size() <= lbSizeMinimizingClause) {
-    //     minimisationWithBinaryResolution(out_learnt);
-    // }
+    if (!incremental && out_learnt.size() <= lbSizeMinimizingClause && computeLBD(out_learnt) <= lbLBDMinimizingClause) {
+        minimisationWithBinaryResolution(out_learnt);
+    }
     // Find correct backtrack level:
     //
     if (out_learnt.size() == 1)
@@ -967,7 +1124,7 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels) {
                         return false;
                     }
                 } else {
-                    if (forbid_units.find(var(p)) != forbid_units.end()) {
+                    if (isESBPUnit(var(p))) {
                         esbp = true;
                         break;
                     }
@@ -1037,8 +1194,8 @@ void Solver::uncheckedEnqueue(Lit p, CRef from) {
     if (decisionLevel() == 0 && from != CRef_Undef) {
         const Clause& c = ca[from];
         for (int i=0; i<c.size(); i++) {
-            if (forbid_units.find(var(c[i])) != forbid_units.end()) {
-                forbid_units.insert(var(p));
+            if (isESBPUnit(var(c[i]))) {
+                setESBPUnit(var(p));
                 break;
             }
         }
@@ -1047,6 +1204,139 @@ void Solver::uncheckedEnqueue(Lit p, CRef from) {
     // updateNotifySEL(p);
 }
 
+/*_________________________________________________________________________________________________
+|
+|  propagateBinaryWatches, propagateTernaryWatches, propagateLongWatches : [Lit]  ->  [Clause*]
+|
+|  Description:
+|    The steps of propagate and propagateLimited for the literal p: the binary clauses, the ternary
+|    clauses (see useTernaryWatches) and the other 2-watched clauses watched by p. Each one returns
+|    the first conflicting clause, otherwise CRef_Undef. The watches of p are consistent in both
+|    cases.
+|________________________________________________________________________________________________@*/
+inline CRef Solver::propagateBinaryWatches(Lit p) {
+    vec<Watcher>& wbin = watchesBin[p];
+
+    for (int k = 0; k < wbin.size(); k++) {
+
+        Lit imp = wbin[k].blocker;
+
+        if (value(imp) == l_False)
+            return wbin[k].cref;
+
+        if (value(imp) == l_Undef) {
+            uncheckedEnqueue(imp, wbin[k].cref);
+        }
+    }
+    return CRef_Undef;
+}
+
+// The clause is only read to put the implied literal first (reasons)
+inline CRef Solver::propagateTernaryWatches(Lit p) {
+    vec<TernaryWatcher>& wter = watchesTer[p];
+
+    for (int k = 0; k < wter.size(); k++) {
+        lbool v1 = value(wter[k].other1);
+        lbool v2 = value(wter[k].other2);
+        if (v1 == l_True || v2 == l_True)
+            continue;
+
+        if (v1 == l_False && v2 == l_False)
+            return wter[k].cref;
+
+        if (v1 == l_False || v2 == l_False) {
+            Lit imp = v1 == l_Undef ? wter[k].other1 : wter[k].other2;
+            Clause& c = ca[wter[k].cref];
+            if (c[1] == imp)
+                c[1] = c[0], c[0] = imp;
+            else if (c[2] == imp)
+                c[2] = c[0], c[0] = imp;
+            uncheckedEnqueue(imp, wter[k].cref);
+        }
+    }
+    return CRef_Undef;
+}
+
+inline CRef Solver::propagateLongWatches(Lit p) {
+    CRef confl = CRef_Undef;
+    vec<Watcher>& ws = watches[p];
+    Watcher *i, *j, *end;
+
+    for (i = j = (Watcher*) ws, end = i + ws.size(); i != end;) {
+        // Try to avoid inspecting the clause:
+        Lit blocker = i->blocker;
+        if (value(blocker) == l_True) {
+            *j++ = *i++;
+            continue;
+        }
+
+        // Make sure the false literal is data[1]:
+        CRef cr = i->cref;
+        Clause& c = ca[cr];
+        assert(!c.getOneWatched());
+        Lit false_lit = ~p;
+        if (c[0] == false_lit)
+            c[0] = c[1], c[1] = false_lit;
+        assert(c[1] == false_lit);
+        i++;
+
+        // If 0th watch is true, then clause is already satisfied.
+        Lit first = c[0];
+        Watcher w = Watcher(cr, first);
+        if (first != blocker && value(first) == l_True) {
+
+            *j++ = w;
+            continue;
+        }
+	if(incremental) { // ----------------- INCREMENTAL MODE
+	  int choosenPos = -1;
+	  for (int k = 2; k < c.size(); k++) {
+
+	    if (value(c[k]) != l_False){
+	      if(decisionLevel()>assumptions.size()) {
+		choosenPos = k;
+		break;
+	      } else {
+		choosenPos = k;
+
+		if(value(c[k])==l_True || !isSelector(var(c[k]))) {
+		  break;
+		}
+	      }
+
+	    }
+	  }
+	  if(choosenPos!=-1) {
+	    c[1] = c[choosenPos]; c[choosenPos] = false_lit;
+	    watches[~c[1]].push(w);
+	    goto NextClause; }
+	} else {  // ----------------- DEFAULT  MODE (NOT INCREMENTAL)
+	  for (int k = 2; k < c.size(); k++) {
+
+	    if (value(c[k]) != l_False){
+	      c[1] = c[k]; c[k] = false_lit;
+	      watches[~c[1]].push(w);
+	      goto NextClause; }
+	  }
+	}
+
+        // Did not find watch -- clause is unit under assignment:
+        *j++ = w;
+        if (value(first) == l_False) {
+            confl = cr;
+            // Copy the remaining watches:
+            while (i < end)
+                *j++ = *i++;
+        } else {
+            uncheckedEnqueue(first, cr);
+        }
+NextClause:
+        ;
+    }
+    ws.shrink(i - j);
+    return confl;
+}
+
 /*_________________________________________________________________________________________________
 |
 |  propagate : [void]  ->  [Clause*]
@@ -1064,113 +1354,35 @@ CRef Solver::propagate() {
     watches.cleanAll();
     watchesBin.cleanAll();
     unaryWatches.cleanAll();
+    watchesTer.cleanAll();
 StartPropagate:
     while (qhead < trail.size()) {
         Lit p = trail[qhead++]; // 'p' is enqueued fact to propagate.
-        vec<Watcher>& ws = watches[p];
-        Watcher *i, *j, *end;
         num_props++;
 
         // ESBP
         if (symmetry != nullptr) {
             symmetry->updateNotify(p, decisionLevel(), reason(var(p)) == CRef_Undef);
             confl = learntSymmetryClause(cosy::ClauseInjector::ESBP, p);
-            if (confl != CRef_Undef)
+            if (confl != CRef_Undef) {
+                ++symesbpconfls;
                 return confl;
-        }
-
-        // First, Propagate binary clauses
-        vec<Watcher>& wbin = watchesBin[p];
-
-        for (int k = 0; k < wbin.size(); k++) {
-
-            Lit imp = wbin[k].blocker;
-
-            if (value(imp) == l_False) {
-                return wbin[k].cref;
             }
+        }
 
-            if (value(imp) == l_Undef) {
-                uncheckedEnqueue(imp, wbin[k].cref);
-            }
+        // First, Propagate binary clauses, then ternary ones
+        CRef cr;
+        if ((cr = propagateBinaryWatches(p)) != CRef_Undef || (cr = propagateTernaryWatches(p)) != CRef_Undef) {
+            propagations += num_props;
+            simpDB_props -= num_props;
+            return cr;
         }
 
         // Now propagate other 2-watched clauses
-        for (i = j = (Watcher*) ws, end = i + ws.size(); i != end;) {
-            // Try to avoid inspecting the clause:
-            Lit blocker = i->blocker;
-            if (value(blocker) == l_True) {
-                *j++ = *i++;
-                continue;
-            }
-
-            // Make sure the false literal is data[1]:
-            CRef cr = i->cref;
-            Clause& c = ca[cr];
-            assert(!c.getOneWatched());
-            Lit false_lit = ~p;
-            if (c[0] == false_lit)
-                c[0] = c[1], c[1] = false_lit;
-            assert(c[1] == false_lit);
-            i++;
-
-            // If 0th watch is true, then clause is already satisfied.
-            Lit first = c[0];
-            Watcher w = Watcher(cr, first);
-            if (first != blocker && value(first) == l_True) {
-
-                *j++ = w;
-                continue;
-            }
-	    if(incremental) { // ----------------- INCREMENTAL MODE
-	      int choosenPos = -1;
-	      for (int k = 2; k < c.size(); k++) {
-
-		if (value(c[k]) != l_False){
-		  if(decisionLevel()>assumptions.size()) {
-		    choosenPos = k;
-		    break;
-		  } else {
-		    choosenPos = k;
-
-		    if(value(c[k])==l_True || !isSelector(var(c[k]))) {
-		      break;
-		    }
-		  }
-
-		}
-	      }
-	      if(choosenPos!=-1) {
-		c[1] = c[choosenPos]; c[choosenPos] = false_lit;
-		watches[~c[1]].push(w);
-		goto NextClause; }
-	    } else {  // ----------------- DEFAULT  MODE (NOT INCREMENTAL)
-	      for (int k = 2; k < c.size(); k++) {
-
-		if (value(c[k]) != l_False){
-		  c[1] = c[k]; c[k] = false_lit;
-		  watches[~c[1]].push(w);
-		  goto NextClause; }
-	      }
-	    }
-
-            // Did not find watch -- clause is unit under assignment:
-            *j++ = w;
-            if (value(first) == l_False) {
-                confl = cr;
-                qhead = trail.size();
-                // Copy the remaining watches:
-                while (i < end)
-                    *j++ = *i++;
-            } else {
-                uncheckedEnqueue(first, cr);
-
-
-            }
-NextClause:
-            ;
+        if ((cr = propagateLongWatches(p)) != CRef_Undef) {
+            confl = cr;
+            qhead = trail.size();
         }
-        ws.shrink(i - j);
 
        // unaryWatches "propagation"
         if (useUnaryWatched &&  confl == CRef_Undef) {
@@ -1184,7 +1396,7 @@ NextClause:
 /*** first check existing symmetrical clauses ***/
     for(; confl == CRef_Undef && qhead_sel<trail.size(); ++qhead_sel){
         Lit prop = trail[qhead_sel];
-        vec<int>& clWatches = *(selClauseWatches[toInt(prop)]);
+        vec<int>& clWatches = selClauseWatches[toInt(prop)];
 
         int watchedclause_i = 0;
         while(watchedclause_i < clWatches.size()){
@@ -1224,7 +1436,7 @@ NextClause:
                 }
             }
             if(value(selClauses[watch])!=l_False){ // new watch found, erase old, create new
-                selClauseWatches[toInt(~selClauses[watch])]->push(currentclause);
+                selClauseWatches[toInt(~selClauses[watch])].push(currentclause);
                 continue;
             }
 
@@ -1241,6 +1453,10 @@ NextClause:
             selGen[currentclause]->getSymmetricalClause(ca[reason(selProp[currentclause])], symmetrical);
 
             minimizeClause(symmetrical);
+            if(symmetrical.size() > 1 && symmetrical.size() <= lbSizeMinimizingClause){
+                prepareWatches(symmetrical);
+                minimisationWithBinaryResolution(symmetrical, c.symmetry() ? 2 : 1);
+            }
             if(symmetrical.size() < 2){
                 assert(symmetrical.size()==1);
                 cancelUntil(0);
@@ -1269,7 +1485,7 @@ NextClause:
         }
     }
 /*** check for new symmetrical clauses ***/
-    for(; confl == CRef_Undef && qhead_gen<trail.size(); ++qhead_gen, watchidx=0){ // do generator symmetry propagation
+    for(; useSEL && confl == CRef_Undef && qhead_gen<trail.size(); ++qhead_gen, watchidx=0){ // do generator symmetry propagation
         Lit currentGenLit = trail[qhead_gen];
         assert(level(var(currentGenLit))==decisionLevel());
 
@@ -1277,7 +1493,7 @@ NextClause:
         int watchEnd = genWatchIndices[var(currentGenLit)+1];
 
         if(level(var(currentGenLit))==0){ // NOTE: special purpose level 0 method needed as not all level 0 propagations have a reason clause attached to it
-            if (forbid_units.find(var(currentGenLit)) != forbid_units.end())
+            if (isESBPUnit(var(currentGenLit)))
                 continue;
             assert(decisionLevel()==0);
             for(int i=watchStart; i<watchEnd; ++i){
@@ -1313,6 +1529,10 @@ NextClause:
             if(result < 2){ // either conflict or unit clause
                 g->getSymmetricalClause(ca[reason_cgl], symmetrical);
                 minimizeClause(symmetrical);
+                if(symmetrical.size() > 1 && symmetrical.size() <= lbSizeMinimizingClause){
+                    prepareWatches(symmetrical);
+                    minimisationWithBinaryResolution(symmetrical, c.symmetry() ? 2 : 1);
+                }
 
                 if(symmetrical.size()<2){
                     assert(symmetrical.size()==1);
@@ -1354,6 +1574,41 @@ ConflDetected:
     return confl;
 }
 
+/*_________________________________________________________________________________________________
+|
+|  propagateLimited : [int64_t&]  ->  [Clause*]
+|
+|  Description:
+|    Cheap unit propagation for the checks of the simplification (asymmetric branching, implied
+|    clauses): only the binary, ternary and long clauses are propagated, without ESBP, SEL, unary
+|    watches or statistics. A conflict found this way only depends on the clauses. Each watcher
+|    visited costs one step of 'steps'; when the budget is spent, the propagation stops before the
+|    next literal and returns CRef_Undef with a non empty queue. The caller backtracks in any case
+|    (cancelUntil also rewinds the symmetry queues, which have not seen these literals).
+|________________________________________________________________________________________________@*/
+CRef Solver::propagateLimited(int64_t& steps) {
+    watches.cleanAll();
+    watchesBin.cleanAll();
+    watchesTer.cleanAll();
+
+    while (qhead < trail.size()) {
+        if (steps <= 0)
+            return CRef_Undef;
+        Lit p = trail[qhead++];
+        vec<Watcher>& ws = watches[p];
+        vec<Watcher>& wbin = watchesBin[p];
+        vec<TernaryWatcher>& wter = watchesTer[p];
+        steps -= 1 + wbin.size() + wter.size() + ws.size();
+
+        CRef cr;
+        if ((cr = propagateBinaryWatches(p)) != CRef_Undef || (cr = propagateTernaryWatches(p)) != CRef_Undef
+            || (cr = propagateLongWatches(p)) != CRef_Undef)
+            return cr;
+    }
+
+    return CRef_Undef;
+}
+
 /*_________________________________________________________________________________________________
 |
 |  propagateUnaryWatches : [Lit]  ->  [Clause*]
@@ -1572,7 +1827,7 @@ lbool Solver::search(int nof_conflicts) {
     bool isSymmetry;
     starts++;
     for (;;) {
-        if (decisionLevel() == 0) { // We import clauses FIXME: ensure that we will import clauses enventually (restart after some point)
+        if (decisionLevel() == 0 || conflicts >= nextImportConflicts) { // We import clauses, at a non-zero level too if restarts are blocked (parallel only)
             parallelImportUnaryClauses();
 
             if (parallelImportClauses())
@@ -1582,8 +1837,10 @@ lbool Solver::search(int nof_conflicts) {
         CRef confl = propagate();
 
         if (confl != CRef_Undef) {
-            if(parallelJobIsFinished())
+            if(parallelJobIsFinished()) {
+                settlePendingESBP();
                 return l_Undef;
+            }
 
 
             sumDecisionLevels += decisionLevel();
@@ -1601,6 +1858,7 @@ lbool Solver::search(int nof_conflicts) {
                         (int) nbReduceDB, nLearnts(), (int) nbDL2, (int) nbRemovedClauses, progressEstimate()*100);
             }
             if (decisionLevel() == 0) {
+                settlePendingESBP();
                 return l_False;
 
             }
@@ -1622,6 +1880,7 @@ lbool Solver::search(int nof_conflicts) {
 
             std::set<SymGenerator*> * comp = new std::set<SymGenerator*>();
             analyze(confl, learnt_clause, selectors, backtrack_level, nblevels,szWithoutSelectors, isSymmetry, comp);
+            settlePendingESBP();
 
             lbdQueue.push(nblevels);
             sumLBD += nblevels;
@@ -1636,10 +1895,9 @@ lbool Solver::search(int nof_conflicts) {
             }
 
             if (learnt_clause.size() == 1) {
-                if (isSymmetry) {
-                    forbid_units.insert(var(learnt_clause[0]));
-                }
                 uncheckedEnqueue(learnt_clause[0]);
+                if (isSymmetry)
+                    setESBPUnit(var(learnt_clause[0]));
 
                 nbUn++;
                 parallelExportUnaryClause(learnt_clause[0]);
@@ -1668,6 +1926,12 @@ lbool Solver::search(int nof_conflicts) {
 
 
         } else {
+            // Stop at the budget (see setConfBudget...): restarts may be blocked for a long time
+            if (!withinBudget()) {
+                cancelUntil(0);
+                return l_Undef;
+            }
+
             // Our dynamic restart, see the SAT09 competition compagnion paper
             if (
                     (lbdQueue.isvalid() && ((lbdQueue.getavg() * K) > (sumLBD / conflictsRestarts)))) {
@@ -1676,6 +1940,10 @@ lbool Solver::search(int nof_conflicts) {
                 int bt = 0;
                 if(incremental) // DO NOT BACKTRACK UNTIL 0.. USELESS
                     bt = (decisionLevel()<assumptions.size()) ? decisionLevel() : assumptions.size();
+                else if (reuseTrail && (bt = reusableTrailLevel()) > 0) {
+                    nbReusedTrails++;
+                    nbReusedLevels += bt;
+                }
                 cancelUntil(bt);
                 return l_Undef;
             }
@@ -1693,6 +1961,8 @@ lbool Solver::search(int nof_conflicts) {
                     reduceDB();
                     if (!panicModeIsEnabled())
                         nbclausesbeforereduce += incReduceDB;
+                    if (metrics != NULL) // Restarts may be blocked for a long time
+                        publishMetrics(SolverMetrics::Running);
                 }
             }
 
@@ -1778,23 +2048,7 @@ lbool Solver::solve_(bool do_simp, bool turn_off_simp) // Parameters are useless
         exit(-1);
     }
 
-    if (symmetry != nullptr) {
-        symmetry->enableCosy(cosy::OrderMode::AUTO,
-                             cosy::ValueMode::TRUE_LESS_FALSE);
-        symmetry->printInfo();
-
-        cosy::ClauseInjector::Type type = cosy::ClauseInjector::UNITS;
-	while (symmetry->hasClauseToInject(type)) {
-
-            std::vector<Lit> literals = symmetry->clauseToInject(type);
-            assert(literals.size() == 1);
-            Lit l = literals[0];
-            if (value(l) == l_Undef) {
-                forbid_units.insert(var(l));
-                uncheckedEnqueue(l);
-            }
-	}
-    }
+    initSymmetry();
 
     model.clear();
     conflict.clear();
@@ -1847,10 +2101,14 @@ lbool Solver::solve_(bool do_simp, bool turn_off_simp) // Parameters are useless
     int curr_restarts = 0;
     while (status == l_Undef){
       status = search(0); // the parameter is useless in glucose, kept to allow modifications
+        if (metrics != NULL && status == l_Undef)
+            publishMetrics(SolverMetrics::Running);
 
         if (!withinBudget()) break;
         curr_restarts++;
     }
+    if (metrics != NULL)
+        publishMetrics(status == l_True ? SolverMetrics::Satisfiable : status == l_False ? SolverMetrics::Unsatisfiable : SolverMetrics::Stopped);
 
     if (!incremental && verbosity >= 1)
       printf("c =========================================================================================================\n");
@@ -1973,6 +2231,7 @@ void Solver::relocAll(ClauseAllocator& to) {
     watches.cleanAll();
     watchesBin.cleanAll();
     unaryWatches.cleanAll();
+    watchesTer.cleanAll();
     for (int v = 0; v < nVars(); v++)
         for (int s = 0; s < 2; s++) {
             Lit p = mkLit(v, s);
@@ -1986,14 +2245,17 @@ void Solver::relocAll(ClauseAllocator& to) {
             vec<Watcher>& ws3 = unaryWatches[p];
             for (int j = 0; j < ws3.size(); j++)
                 ca.reloc(ws3[j].cref, to);
+            vec<TernaryWatcher>& ws4 = watchesTer[p];
+            for (int j = 0; j < ws4.size(); j++)
+                ca.reloc(ws4[j].cref, to);
         }
 
-    // All reasons:
+    // All reasons, including the lazy SEL reasons (not attached, thus not always locked):
     //
     for (int i = 0; i < trail.size(); i++) {
         Var v = var(trail[i]);
 
-        if (reason(v) != CRef_Undef && (ca[reason(v)].reloced() || locked(ca[reason(v)])))
+        if (reason(v) != CRef_Undef && (ca[reason(v)].reloced() || ca[reason(v)].lazyReason() || locked(ca[reason(v)])))
             ca.reloc(vardata[v].reason, to);
     }
 
@@ -2009,6 +2271,11 @@ void Solver::relocAll(ClauseAllocator& to) {
 
     for (int i = 0; i < unaryWatchedClauses.size(); i++)
         ca.reloc(unaryWatchedClauses[i], to);
+
+    // ESBP conflict clause not settled yet:
+    //
+    if (pendingESBP != CRef_Undef)
+        ca.reloc(pendingESBP, to);
 }
 
 
@@ -2025,6 +2292,68 @@ void Solver::garbageCollect() {
     to.moveTo(ca);
 }
 
+//=================================================================================================
+// Live metrics:
+
+void Solver::publishMetrics(int status) {
+    assert(metrics != NULL);
+    SolverMetrics& m = *metrics;
+    double now = realTime();
+
+    // The memory figures need a pass on all the watch lists: they are refreshed at most once per
+    // second, and computed before the update to keep the slot consistent as long as possible
+    bool refreshMemory = now - metricsMemoryTime >= 1.0;
+    double memClauses = 0, memWatches = 0, memSymmetry = 0, memTotal = 0;
+    if (refreshMemory) {
+        uint64_t watchBytes = 0, selBytes = 0;
+        for (int v = 0; v < nVars(); v++)
+            for (int s = 0; s < 2; s++) {
+                Lit p = mkLit(v, s);
+                watchBytes += (uint64_t)(watches[p].capacity() + watchesBin[p].capacity() + unaryWatches[p].capacity()) * sizeof(Watcher)
+                            + (uint64_t)watchesTer[p].capacity() * sizeof(TernaryWatcher);
+                selBytes += (uint64_t)selClauseWatches[toInt(p)].capacity() * sizeof(int);
+            }
+        selBytes += (uint64_t)selClauses.capacity() * sizeof(Lit) + (uint64_t)(selIdx.capacity() + selProp.capacity()) * sizeof(int)
+                  + (uint64_t)selGen.capacity() * sizeof(SymGenerator*);
+
+        metricsMemoryTime = now;
+        memClauses  = (double)ca.size() * ClauseAllocator::Unit_Size / (1024*1024);
+        memWatches  = (double)watchBytes / (1024*1024);
+        memSymmetry = (double)selBytes / (1024*1024);
+        memTotal    = memUsed();
+    }
+
+    MetricsFile::beginUpdate(m);
+    m.status           = status;
+    m.cpu_time         = cpuTime();
+    m.real_time        = now;
+    m.conflicts        = conflicts;
+    m.decisions        = decisions;
+    m.propagations     = propagations;
+    m.restarts         = starts;
+    m.blocked_restarts = nbstopsrestarts;
+    m.reduce_db        = nbReduceDB;
+    m.clauses          = nClauses();
+    m.learnts          = nLearnts();
+    m.learnts_literals = learnts_literals;
+    m.root_assigns     = trail_lim.size() == 0 ? trail.size() : trail_lim[0];
+    if (refreshMemory) {
+        m.mem_total    = memTotal;
+        m.mem_clauses  = memClauses;
+        m.mem_watches  = memWatches;
+        m.mem_symmetry = memSymmetry;
+    }
+    m.symgenprops      = symgenprops;
+    m.symgenconfls     = symgenconfls;
+    m.symselprops      = symselprops;
+    m.symselconfls     = symselconfls;
+    m.symselkept       = symselkept;
+    m.symesbpconfls    = symesbpconfls;
+    m.symesbpkept      = symesbpkept;
+    m.symesbplits      = symesbplits;
+    MetricsFile::endUpdate(m);
+}
+
 //--------------------------------------------------------------
 // Functions related to MultiThread.
 // Useless in case of single core solver (aka original glucose)
@@ -2114,7 +2443,7 @@ void Solver::minimizeClause(vec<Lit>& cl){
             continue;
         }
         if(level(var(cl[i]))==0){
-            if (forbid_units.find(var(cl[i])) != forbid_units.end()) {
+            if (isESBPUnit(var(cl[i]))) {
                 isSymmetry = true;
                 break;
             }
@@ -2125,7 +2454,7 @@ void Solver::minimizeClause(vec<Lit>& cl){
             bool allSeen = true;
             for(int j=0; j<expl.size(); ++j){
                 int var_j = var(expl[j]);
-                if (forbid_units.find(var_j) != forbid_units.end()) {
+                if (level(var_j) == 0 && isESBPUnit(var_j)) {
                     isSymmetry = true;
                     break;
                 }
@@ -2159,6 +2488,53 @@ void Solver::minimizeClause(vec<Lit>& cl){
     }
 }
 
+// Same as minimizeClause for a falsified ESBP clause. It depends on the symmetries anyway, but a literal
+// is only removed if this does not make it depend on ESBP units: then it is just kept. The order of the
+// remaining literals is unchanged, and the clause is left as is if none of them would be at the current
+// level (the conflict could not be analysed).
+void Solver::minimizeESBPClause(vec<Lit>& cl){
+    vec<Lit> copyCl;
+    cl.copyTo(copyCl);
+    for(int i=0; i<cl.size(); ++i){
+        assert(value(cl[i])==l_False);
+        assert(seen[var(cl[i])]==0);
+        seen[var(cl[i])]=1; // removed literals stay marked
+    }
+
+    int i, j;
+    for(i=j=0; i<cl.size(); ++i){
+        bool removable = false;
+        Var v = var(cl[i]);
+        if(j+cl.size()-i <= 1){
+            // keep at least one literal
+        }else if(level(v)==0){
+            removable = !isESBPUnit(v);
+        }else if(reason(v)!=CRef_Undef && !ca[reason(v)].symmetry()){
+            const Clause& expl = ca[reason(v)];
+            removable = true;
+            for(int k=0; k<expl.size() && removable; ++k){
+                Var var_k = var(expl[k]);
+                if(var_k == v) continue;
+                if(level(var_k)==0) removable = !isESBPUnit(var_k);
+                else                removable = seen[var_k];
+            }
+        }
+        if(!removable) cl[j++] = cl[i];
+    }
+    cl.shrink(i-j);
+
+    for(int k=0; k<copyCl.size(); ++k) // reset seen
+        seen[var(copyCl[k])]=0;
+
+    bool atLevel = false;
+    for(int k=0; k<cl.size() && !atLevel; ++k)
+        atLevel = level(var(cl[k])) == decisionLevel();
+    if(!atLevel)
+        copyCl.copyTo(cl);
+    else
+        symesbplits += copyCl.size() - cl.size();
+}
+
 // NOTE: sometimes backtracks to add unit clause instead of conflict clause
 CRef Solver::addClauseFromSymmetry(const Clause& from, vec<Lit>& symmetrical){
     assert(symmetrical.size() > 0);
@@ -2166,9 +2542,6 @@ CRef Solver::addClauseFromSymmetry(const Clause& from, vec<Lit>& symmetrical){
     CRef cr = ca.alloc(symmetrical, true, false, false, from.symmetry(), from.scompat());
     ca[cr].setOneWatched(false);
 	  //ca[cr].setSizeWithoutSelectors(szWithoutSelectors); // TODO: Is this code needed? What does it do?
-    learnts.push(cr);
-    attachClause(cr);
-    claBumpActivity(ca[cr]);
     if(symmetrical.size() <= 1){
         cancelUntil(0);
     } else {
@@ -2177,10 +2550,21 @@ CRef Solver::addClauseFromSymmetry(const Clause& from, vec<Lit>& symmetrical){
     }
 
     if(value(symmetrical[0])==l_Undef){
+        if(lazySELReasons && decisionLevel() > 0){ // only a reason: attached by analyze if it takes part in a conflict
+            ca[cr].setLazyReason(true);
+            selLazyReasons.push(var(symmetrical[0]));
+        } else {
+            learnts.push(cr);
+            attachClause(cr);
+            claBumpActivity(ca[cr]);
+        }
         uncheckedEnqueue(symmetrical[0], cr);
         return CRef_Undef; // unit clause, added to clause store
     }
     assert(value(symmetrical[0])==l_False);
+    learnts.push(cr);
+    attachClause(cr);
+    claBumpActivity(ca[cr]);
     return cr; // conflict clause, need to backtrack
 }
 
@@ -2188,15 +2572,16 @@ int Solver::addSelClause(SymGenerator* g, Lit l){
     CRef reason_l = reason(var(l));
     assert(reason_l != CRef_Undef);
 
+    // One pass over the images: the literals pushed before a satisfied one are dropped
     const Clause& c_l = ca[reason_l];
     for(int i=0; i<c_l.size(); ++i){
-        if(value(g->getImage(c_l[i])) == l_True) { // unknown lits, keep in clause
+        Lit symLit = g->getImage(c_l[i]);
+        lbool val = value(symLit);
+        if(val==l_True){ // satisfied symmetrical clause
+            selClauses.shrink_(selClauses.size()-selIdx.last());
             return 2;
         }
-    }
-    for(int i=0; i<c_l.size(); ++i){
-        Lit symLit = g->getImage(c_l[i]);
-        if(value(symLit)==l_Undef){ // unknown lits, keep in clause
+        if(val==l_Undef){ // unknown lits, keep in clause
             selClauses.push(symLit);
         } // else value is l_False, will never change, so can safely be ignored
     }
@@ -2209,8 +2594,9 @@ int Solver::addSelClause(SymGenerator* g, Lit l){
     assert(decisionLevel()>0); // NOTE: level 0 means clauses of length 1, should have been handled earlier
     assert(nbAddedLits>=2);
     int selClauseId = selProp.size(); // id for selClause
-    selClauseWatches[toInt(~selClauses[selIdx.last()])]->push(selClauseId); // negation of first literal is watch
-    selClauseWatches[toInt(~selClauses[selIdx.last()+1])]->push(selClauseId); // negation of second literal is watch
+    selClauseWatches[toInt(~selClauses[selIdx.last()])].push(selClauseId); // negation of first literal is watch
+    selClauseWatches[toInt(~selClauses[selIdx.last()+1])].push(selClauseId); // negation of second literal is watch
+    selWatched = true;
     selIdx.push(selClauses.size());
     selGen.push(g);
     selProp.push(var(l));
@@ -2289,6 +2675,22 @@ void Solver::notifyCNFUnits() {
     }
 }
 
+void Solver::settlePendingESBP() {
+    if (pendingESBP == CRef_Undef)
+        return;
+
+    Clause& c = ca[pendingESBP];
+    if (c.size() > 1 && c.lbd() <= lbLBDKeepESBP) { // A unit is learnt by analyze
+        learnts.push(pendingESBP);
+        attachClause(pendingESBP);
+        symesbpkept++;
+    } else {
+        delete c.scompat();
+        ca.free(pendingESBP);
+    }
+    pendingESBP = CRef_Undef;
+}
+
 CRef Solver::learntSymmetryClause(cosy::ClauseInjector::Type type, Lit p) {
     if (symmetry != nullptr) {
         if (symmetry->hasClauseToInject(type, p)) {
@@ -2296,20 +2698,19 @@ CRef Solver::learntSymmetryClause(cosy::ClauseInjector::Type type, Lit p) {
 
             // Dirty make a copy of vector
             vec<Lit> sbp;
-            int max_i = 0;
-            int lvl = level(var(vsbp[max_i]));
-
-            int i = 0;
-            for (Lit l : vsbp) {
+            for (Lit l : vsbp)
                 sbp.push(l);
-                if (i > 1 && level(var(l)) > lvl) {
-                    max_i = i;
-                    lvl = level(var(vsbp[max_i]));
-                }
-                i++;
+            if (minimizeESBP)
+                minimizeESBPClause(sbp);
+
+            // Watch the two literals of highest levels, as after a conflict analysis
+            for (int w = 0; w < 2 && w < sbp.size(); w++) {
+                int max_i = w;
+                for (int i = w + 1; i < sbp.size(); i++)
+                    if (level(var(sbp[i])) > level(var(sbp[max_i])))
+                        max_i = i;
+                std::swap(sbp[w], sbp[max_i]);
             }
-            if (max_i != 0)
-                std::swap(sbp[0], sbp[max_i]);
 
             std::set<SymGenerator*> * comp = new std::set<SymGenerator*>();
 
@@ -2320,13 +2721,15 @@ CRef Solver::learntSymmetryClause(cosy::ClauseInjector::Type type, Lit p) {
                     comp->insert(g);
             }
 
+            // The clause is falsified: it is only used as a conflict. It is attached once the
+            // conflict is analysed, if it is worth keeping (see settlePendingESBP)
+            settlePendingESBP(); // Conflict of a propagation made outside search
             CRef cr = ca.alloc(sbp, true, false, true, true, comp);
             assert(ca[cr].symmetry());
             ca[cr].setLBD(computeLBD(ca[cr]));
             ca[cr].setOneWatched(false);
             // ca[cr].setSizeWithoutSelectors(0);  // I don't know how to put here !!!
-            learnts.push(cr);
-            attachClause(cr);
+            pendingESBP = cr;
 
             return cr;
         }
@@ -2334,11 +2737,43 @@ CRef Solver::learntSymmetryClause(cosy::ClauseInjector::Type type, Lit p) {
     return CRef_Undef;
 }
 
+void Solver::initSymmetry() {
+    assert(decisionLevel() == 0);
+    if (symmetry == nullptr)
+        return;
+
+    symmetry->enableCosy(esbpOrder, cosy::ValueMode::TRUE_LESS_FALSE);
+    if (verbosity > 0)
+        symmetry->printInfo();
+
+    cosy::ClauseInjector::Type type = cosy::ClauseInjector::UNITS;
+    while (symmetry->hasClauseToInject(type)) {
+
+        std::vector<Lit> literals = symmetry->clauseToInject(type);
+        assert(literals.size() == 1);
+        Lit l = literals[0];
+        if (value(l) == l_Undef) {
+            uncheckedEnqueue(l);
+            setESBPUnit(var(l));
+        }
+    }
+}
+
+void Solver::setSEL(bool enabled) {
+    assert(decisionLevel() == 0);
+    if (enabled && !useSEL) {
+        // Level 0 literals were not seen by the generators
+        qhead_gen = 0;
+        watchidx = 0;
+    }
+    useSEL = enabled;
+}
+
 void Solver::computeValidSymmetriesLevelZero() {
     validSymmetries.clear();
     vec<Lit> need_stab;
     for (int i=0; i<trail.size(); i++) {
-        if (forbid_units.find(var(trail[i])) != forbid_units.end())
+        if (isESBPUnit(var(trail[i])))
             need_stab.push(trail[i]);
     }
 
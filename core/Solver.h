@@ -55,6 +55,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "mtl/Heap.h"
 #include "mtl/Alg.h"
 #include "utils/Options.h"
+#include "utils/Metrics.h"
 #include "core/SolverTypes.h"
 #include "core/BoundedQueue.h"
 #include "core/Constants.h"
@@ -103,11 +104,19 @@ public:
     //
     std::unique_ptr<cosy::SymmetryController<Lit>> symmetry;
     CRef learntSymmetryClause(cosy::ClauseInjector::Type type, Lit p);
+    void settlePendingESBP();     // Keep the pending ESBP conflict clause as a learnt, or free it
     void notifyCNFUnits();
     void computeValidSymmetriesLevelZero();
 
     std::unordered_set<SymGenerator*> validSymmetries;
-    std::unordered_set<Var> forbid_units;
+    bool isESBPUnit(Var x) const; // True if x is a level 0 unit deduced with ESBP (it must not be used by SEL nor shared)
+    void setESBPUnit(Var x);      // Flags the level 0 unit x as deduced with ESBP
+
+    bool useSEL;                  // Symmetric explanation learning on the generators (if any)
+    bool lazySELReasons;          // SEL propagations use unattached reasons, kept only if they take part in a conflict
+    bool minimizeESBP;            // ESBP conflict clauses are shortened before use (see minimizeESBPClause)
+    cosy::OrderMode esbpOrder;    // Variable order used by ESBP (if a symmetry controller is set)
+    void setSEL(bool enabled);    // Switch SEL on or off (at level 0 only)
 
     void updateNotifySEL(Lit p);
     void updateCancelSEL(Lit p);
@@ -164,8 +173,11 @@ public:
     // Resource contraints:
     //
     void    setConfBudget(int64_t x);
-    void    setPropBudget(int64_t x);
+    void    setPropBudget(int64_t x);   // Of propagation work, symmetries included (see propagationWork).
+    void    setTimeBudget(double x);    // Wall clock seconds from now.
+    void    setMemBudget (double x);    // Megabytes of the whole process (see memUsed).
     void    budgetOff();
+    uint64_t propagationWork() const;   // Propagations, and the literals and conflicts derived by SEL and ESBP.
     void    interrupt();          // Trigger a (potentially asynchronous) interruption of the solver.
     void    clearInterrupt();     // Clear interrupt indicator flag.
 
@@ -192,6 +204,7 @@ public:
     double    R;
     double    sizeLBDQueue;
     double    sizeTrailQueue;
+    bool      reuseTrail;         // Keep the decision levels that would be picked again after a restart
 
     // Constants for reduce DB
     int          firstReduceDB;
@@ -203,6 +216,9 @@ public:
     int          lbSizeMinimizingClause;
     unsigned int lbLBDMinimizingClause;
 
+    // Constant for ESBP conflict clauses
+    unsigned int lbLBDKeepESBP;       // ESBP conflict clauses are kept as learnts only if their LBD is at most this
+
     // Constant for heuristic
     double    var_decay;
     double    max_var_decay;
@@ -226,7 +242,9 @@ public:
     uint32_t panicModeLastRemoved, panicModeLastRemovedShared;
 
     bool useUnaryWatched;            // Enable unary watched literals
+    bool useTernaryWatches;          // Ternary clauses are in watchesTer instead of watches (not in incremental mode)
     bool promoteOneWatchedClause;    // One watched clauses are promotted to two watched clauses if found empty
+    uint64_t nextImportConflicts;    // From this number of conflicts, shared clauses are also imported at a non-zero level (never in the sequential case)
 
     // Functions useful for multithread solving
     // Useless in the sequential case
@@ -249,14 +267,18 @@ public:
     uint64_t nbRemovedClauses,nbRemovedUnaryWatchedClauses, nbReducedClauses,nbDL2,nbBin,nbUn,nbReduceDB,solves, starts, decisions, rnd_decisions, propagations,
         conflicts,conflictsRestarts,nbstopsrestarts,nbstopsrestartssame,lastblockatrestart;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t nbReusedTrails, nbReusedLevels; // Restarts that kept a part of the trail, and number of decision levels kept
+    uint64_t nbReducedLits;                  // Literals removed by the minimisation with binary resolution (see nbReducedClauses)
 
 protected:
 
     long curRestart;
     // Helper structures:
     //
-    struct VarData { CRef reason; int level; };
-    static inline VarData mkVarData(CRef cr, int l){ VarData d = {cr, l}; return d; }
+    // Hot per-variable state, read together by propagate, analyze and minimizeClause: one 8 bytes
+    // record per variable. esbpUnit is set on the level 0 units deduced with ESBP (see isESBPUnit).
+    struct VarData { CRef reason; unsigned level : 31; unsigned esbpUnit : 1; };
+    static inline VarData mkVarData(CRef cr, int l){ VarData d = {cr, (unsigned)l, 0}; return d; }
 
     struct Watcher {
         CRef cref;
@@ -279,6 +301,23 @@ protected:
         bool operator()(const Watcher& w) const { return ca[w.cref].mark() == 1; }
     };
 
+    // Ternary clauses are watched by their three literals, with both other literals inline (see
+    // useTernaryWatches): the clause itself is only read when it propagates.
+    struct TernaryWatcher {
+        CRef cref;
+        Lit  other1, other2;
+        TernaryWatcher(CRef cr, Lit o1, Lit o2) : cref(cr), other1(o1), other2(o2) {}
+        bool operator==(const TernaryWatcher& w) const { return cref == w.cref; }
+        bool operator!=(const TernaryWatcher& w) const { return cref != w.cref; }
+    };
+
+    struct TernaryWatcherDeleted
+    {
+        const ClauseAllocator& ca;
+        TernaryWatcherDeleted(const ClauseAllocator& _ca) : ca(_ca) {}
+        bool operator()(const TernaryWatcher& w) const { return ca[w.cref].mark() == 1; }
+    };
+
     struct VarOrderLt {
         const vec<double>&  activity;
         bool operator () (Var x, Var y) const { return activity[x] > activity[y]; }
@@ -299,6 +338,8 @@ protected:
                         watchesBin;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
     OccLists<Lit, vec<Watcher>, WatcherDeleted>
                         unaryWatches;       //  Unary watch scheme (clauses are seen when they become empty
+    OccLists<Lit, vec<TernaryWatcher>, TernaryWatcherDeleted>
+                        watchesTer;         // Ternary clauses, if useTernaryWatches
     vec<CRef>           clauses;          // List of problem clauses.
     vec<CRef>           learnts;          // List of learnt clauses.
     vec<CRef>           unaryWatchedClauses;  // List of imported clauses (after the purgatory) // TODO put inside ParallelSolver
@@ -309,7 +350,7 @@ protected:
     vec<Lit>            trail;            // Assignment stack; stores all assigments made in the order they were made.
     vec<int>            nbpos;
     vec<int>            trail_lim;        // Separator indices for different decision levels in 'trail'.
-    vec<VarData>        vardata;          // Stores reason and level for each variable.
+    vec<VarData>        vardata;          // Stores reason, level and flags for each variable.
     int                 qhead;            // Head of queue (as index into the trail -- no more explicit propagation queue in MiniSat).
     int                 simpDB_assigns;   // Number of top-level assignments since last execution of 'simplify()'.
     int64_t             simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplify()'.
@@ -320,6 +361,8 @@ protected:
     bool reduceOnSize;
     int  reduceOnSizeSize;                // See XMinisat paper
     vec<unsigned int>   permDiff;           // permDiff[var] contains the current conflict number... Used to count the number of  LBD
+    vec<unsigned int>   binResStamp;        // binResStamp[lit] == binResFlag iff ~lit is in the clause minimised with binary resolution
+    unsigned int        binResFlag;
 
 
     // UPDATEVARACTIVITY trick (see competition'09 companion paper)
@@ -334,6 +377,7 @@ protected:
     float sumLBD; // used to compute the global average of LBD. Restarts...
     int sumAssumptions;
     CRef lastLearntClause;
+    CRef pendingESBP;                 // ESBP conflict clause not attached yet (see learntSymmetryClause)
 
 
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which it is
@@ -354,6 +398,10 @@ protected:
     //
     int64_t             conflict_budget;    // -1 means no budget.
     int64_t             propagation_budget; // -1 means no budget.
+    double              time_budget;        // Deadline (see realTime), -1 means no budget.
+    double              memory_budget;      // -1 means no budget.
+    mutable uint64_t    budget_checks;      // The clock and the memory are only read every few checks,
+    mutable bool        budget_exhausted;   // until one of them runs out.
     bool                asynch_interrupt;
 
     // Variables added for incremental mode
@@ -373,7 +421,12 @@ protected:
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
     CRef     propagateUnaryWatches(Lit p);                                                  // Perform propagation on unary watches of p, can find only conflicts
+    CRef     propagateLimited (int64_t& steps);                                        // Unit propagation on the clauses only (no symmetries), within a budget of steps.
+    CRef     propagateBinaryWatches(Lit p);                                                 // Propagates the binary clauses watched by p, returns a conflict or CRef_Undef.
+    CRef     propagateTernaryWatches(Lit p);                                                // Same for the ternary clauses (steps of propagate and propagateLimited).
+    CRef     propagateLongWatches(Lit p);                                                   // Same for the other 2-watched clauses.
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
+    int      reusableTrailLevel();                                                     // Number of decision levels a restart can keep.
     void     analyze          (CRef confl, vec<Lit>& out_learnt, vec<Lit> & selectors, int& out_btlevel,unsigned int &nblevels,unsigned int &szWithoutSelectors, bool &isSymmetry, std::set<SymGenerator*>* comp);    // (bt = backtrack)
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
@@ -382,6 +435,7 @@ protected:
     virtual void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
     void     rebuildOrderHeap ();
+    void     initSymmetry     ();                                                      // Enable ESBP and enqueue its units (before search).
 
     // Maintaining Variable/Clause activity:
     //
@@ -403,7 +457,7 @@ protected:
 
     unsigned int computeLBD(const vec<Lit> & lits,int end=-1);
     unsigned int computeLBD(const Clause &c);
-    void minimisationWithBinaryResolution(vec<Lit> &out_learnt);
+    int  minimisationWithBinaryResolution(vec<Lit> &c, int minSize = 1); // Returns the number of removed literals
 
     virtual void     relocAll         (ClauseAllocator& to);
 
@@ -415,6 +469,7 @@ protected:
     int      level            (Var x) const;
     double   progressEstimate ()      const; // DELETE THIS ?? IT'S NOT VERY USEFUL ...
     bool     withinBudget     ()      const;
+    bool     withinResourceBudget()   const;                                           // Wall clock and memory part of withinBudget.
     inline bool isSelector(Var v) {return (incremental && v>nbVarsInitialFormula);}
 
     // Static helpers:
@@ -440,13 +495,16 @@ private:
 
 /*** Symmetric Explanation Learning (SEL) data structures ***/
     int qhead_sel; // Head of queue (as index into the trail -- no more explicit propagation queue in MiniSat).
+    bool selWatched; // A SEL clause was watched since the last backtrack to level 0 (which clears the watches).
     vec<Lit> selClauses; // contiguous list of (shortened) symmetrical explanation clauses. Grows/shrinks as current assignment increases/decreases.
     vec<int> selIdx; // start- and endpoint of each selClause. Idx[i] is start point of clause i, Idx[i+1] is end point.
     vec<int> selProp; // original propagated variable for selClause
     vec<SymGenerator*> selGen; // original generator for selClause
-    vec<vec<int>* > selClauseWatches; // map of Lits to selClauses, being the 0th or 1st lit of a symmetric explanation clause, which is watched on becoming true.
+    vec<vec<int> > selClauseWatches; // map of Lits to selClauses, being the 0th or 1st lit of a symmetric explanation clause, which is watched on becoming true.
+    vec<Var> selLazyReasons; // variables propagated by a SEL clause not attached yet (lazyReason), in trail order. Freed on backtrack.
 
     void minimizeClause(vec<Lit>& c); // minimize clause through self-subsumption
+    void minimizeESBPClause(vec<Lit>& c); // same for a falsified ESBP clause, keeping the literals that depend on ESBP units
     void prepareWatches(vec<Lit>& c); // prepares watches of a (new) clause
     CRef addClauseFromSymmetry(const Clause& from, vec<Lit>& symmetrical); // @pre: clause is unit or conflicting. Bool return value is true if the symmetrical clause is unit or conflicting. CRef return value is the conflicting clause, or CRef_Undef if the symmetrical clause is not conflicting.
 
@@ -463,10 +521,21 @@ public:
     uint64_t symgenconfls;
     uint64_t symselprops;
     uint64_t symselconfls;
+    uint64_t symselkept;          // Lazy SEL reasons attached because they took part in a conflict
+    uint64_t symesbpconfls;
+    uint64_t symesbpkept;
+    uint64_t symesbplits;         // Literals removed from the ESBP conflict clauses by minimizeESBPClause
+
+    // Live metrics (see utils/Metrics.h): the slot of this solver, if any, written at restarts and reduceDB
+    SolverMetrics* metrics;
+    double metricsMemoryTime;     // Real time of the last refresh of the memory figures
+    void publishMetrics(int status);
+
     void addGenerator(SymGenerator* g);
     void initiateGenWatches();
 
-    int nGenerators(){return generators.size();}
+    int nGenerators() const {return generators.size();}
+    const SymGenerator* generator(int i) const {return generators[i];}
 
     void printClause(const vec<Lit>& cl){
         for(int64_t i=0; i<cl.size(); ++i){
@@ -492,6 +561,8 @@ public:
 
 inline CRef Solver::reason(Var x) const { return vardata[x].reason; }
 inline int  Solver::level (Var x) const { return vardata[x].level; }
+inline bool Solver::isESBPUnit(Var x) const { return vardata[x].esbpUnit; }
+inline void Solver::setESBPUnit(Var x) { assert(level(x) == 0 && value(x) != l_Undef); vardata[x].esbpUnit = 1; }
 
 inline void Solver::insertVarOrder(Var x) {
     if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x); }
@@ -560,14 +631,17 @@ inline void     Solver::setDecisionVar(Var v, bool b)
     insertVarOrder(v);
 }
 inline void     Solver::setConfBudget(int64_t x){ conflict_budget    = conflicts    + x; }
-inline void     Solver::setPropBudget(int64_t x){ propagation_budget = propagations + x; }
+inline void     Solver::setPropBudget(int64_t x){ propagation_budget = propagationWork() + x; }
 inline void     Solver::interrupt(){ asynch_interrupt = true; }
 inline void     Solver::clearInterrupt(){ asynch_interrupt = false; }
-inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; }
+inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; time_budget = memory_budget = -1; budget_exhausted = false; }
+inline uint64_t Solver::propagationWork() const {
+    return propagations + symgenprops + symgenconfls + symselprops + symselconfls + symesbpconfls; }
 inline bool     Solver::withinBudget() const {
     return !asynch_interrupt &&
            (conflict_budget    < 0 || conflicts < (uint64_t)conflict_budget) &&
-           (propagation_budget < 0 || propagations < (uint64_t)propagation_budget); }
+           (propagation_budget < 0 || propagationWork() < (uint64_t)propagation_budget) &&
+           ((time_budget < 0 && memory_budget < 0) || withinResourceBudget()); }
 
 // FIXME: after the introduction of asynchronous interrruptions the solve-versions that return a
 // pure bool do not give a safe interface. Either interrupts must be possible to turn off here, or
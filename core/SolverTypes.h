@@ -168,6 +168,7 @@ class Clause {
       unsigned symmetry   : 1;
       unsigned szWithoutSelectors : BITS_SIZEWITHOUTSEL;
       unsigned canbedel   : 1;
+      unsigned lazyReason : 1; // learnt clause used as a reason but not attached (see Solver::addClauseFromSymmetry)
       unsigned extra_size : 2; // extra size (end of 32bits) 0..3
       unsigned size       : BITS_REALSIZE;
       unsigned seen       : 1;
@@ -195,6 +196,7 @@ class Clause {
         header.size      = ps.size();
 	header.lbd = 0;
 	header.canbedel = 1;
+	header.lazyReason = 0;
 	header.exported = 0;
 	header.oneWatched = 0;
 	header.seen = 0;
@@ -265,6 +267,8 @@ public:
     unsigned int        lbd    () const        { return header.lbd; }
     void setCanBeDel(bool b) {header.canbedel = b;}
     bool canBeDel() {return header.canbedel;}
+    void setLazyReason(bool b) {header.lazyReason = b;}
+    bool lazyReason() const {return header.lazyReason;}
     void setSeen(bool b) {header.seen = b;}
     bool getSeen() {return header.seen;}
     void setExported(unsigned int b) {header.exported = b;}
@@ -349,6 +353,7 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
 	  to[cr].setSeen(c.getSeen());
 	  to[cr].setSizeWithoutSelectors(c.sizeWithoutSelectors());
 	  to[cr].setCanBeDel(c.canBeDel());
+	  to[cr].setLazyReason(c.lazyReason());
 	  if (c.wasImported()) {
              to[cr].setImportedFrom(c.importedFrom());
 	  }
@@ -561,6 +566,10 @@ public:
         }
     }
 
+    SymGenerator(const SymGenerator& g) : offset(g.offset) {
+        g.image.copyTo(image);
+    }
+
     bool stabilize(const vec<Lit>& clause) const {
         for (int i=0; i<clause.size(); i++) {
             if (!permutes(clause[i]))
@@ -587,17 +596,18 @@ public:
         printf("\n");
     }
 
+    // A single unsigned comparison checks both bounds of the image
     inline Lit getImage(Lit l) const {
-        int index = var(l)-offset;
-        if(index<0 || index>=image.size()){
+        unsigned index = var(l)-offset;
+        if(index>=(unsigned)image.size()){
             return l;
         }
         return image[index]^sign(l);
     }
 
     inline bool permutes(Lit l) const {
-        int index = var(l)-offset;
-        return (index>=0 && index<image.size() && (image[index]^sign(l))!=l);
+        unsigned index = var(l)-offset;
+        return (index<(unsigned)image.size() && (image[index]^sign(l))!=l);
     }
 
     void getSymmetricalClause(const Clause& in_clause, vec<Lit>& out_clause){
@@ -121,6 +121,33 @@ class Heap {
     }
 
 
+    // The next k elements returned by removeMin, if the heap is not changed meanwhile. They are
+    // removed as removeMin does, then the heap is restored as it was (same layout, so same order).
+    void peekMins(int k, vec<int>& out)
+    {
+        vec<int> undo; // Pairs (position, previous element)
+        int      size = heap.size();
+        out.clear();
+        while (out.size() < k && size > 0){
+            out.push(heap[0]);
+            int x = heap[--size];
+            int i = 0;
+            if (size == 0) break;
+            while (left(i) < size){
+                int child = right(i) < size && lt(heap[right(i)], heap[left(i)]) ? right(i) : left(i);
+                if (!lt(heap[child], x)) break;
+                undo.push(i); undo.push(heap[i]);
+                heap[i] = heap[child];
+                i       = child;
+            }
+            undo.push(i); undo.push(heap[i]);
+            heap[i] = x;
+        }
+        for (int j = undo.size() - 2; j >= 0; j -= 2)
+            heap[undo[j]] = undo[j + 1];
+    }
+
+
     // Rebuild the heap from scratch, using the elements in 'ns':
     void build(vec<int>& ns) {
         for (int i = 0; i < heap.size(); i++)
@@ -50,15 +50,19 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 /* ClausesBuffer
  *
  * This class is responsible for exchanging clauses between threads.
- * It is based on a fixed-length FIFO array of literals.
- * If the FIFO is full, then old clauses are removed (even if it was not yet sent to all threads)
+ * It is based on a FIFO array of literals, with a cursor by reader thread.
+ * If the FIFO is full, its size is doubled, up to fifomaxsize by thread: producers faster than the
+ * slowest reader get more room. Then, the oldest clauses are removed (even if they were not yet
+ * sent to all threads) only when they are worse than the new one (LBD, then size), or always with
+ * removeolder. Otherwise, the new clause is rejected.
  *
- * a clause " l1 l2 l3" is pushed in the FIFO with the following 6 unsigned integers
- * 3 nseen origin l1 l2 l3
+ * a clause " l1 l2 l3" is pushed in the FIFO with the following 7 unsigned integers
+ * 3 nseen origin lbd l1 l2 l3
  * + 3 is the size of the pushed clause
  * + nseen is the number of thread which imported this clause (initialized with nthreads-1)
  *       (when set to 0, the clause is removed from the fifo)
  * + origin is the thread id of the thread which added this clause to the fifo
+ * + lbd is the LBD of the clause in the origin thread
  * + l1 l2 l3 are the literals of the clause
  *
  * **********************************************************************************************
@@ -76,32 +80,52 @@ using namespace Glucose;
 
 extern BoolOption opt_whenFullRemoveOlder;
 extern IntOption  opt_fifoSizeByCore;
+extern IntOption  opt_fifoMaxSizeByCore;
 
 // index : size clause
 // index + 1 : nbSeen
 // index + 2 : threadId
-// index + 3 : .. index + 3 + size : Lit of clause
+// index + 3 : lbd
+// index + 4 : .. index + 4 + size : Lit of clause
 ClausesBuffer::ClausesBuffer(int _nbThreads, unsigned int _maxsize) : first(0), last(_maxsize-1),  
-    maxsize(_maxsize), queuesize(0), 
+    maxsize(_maxsize), maxcapacity(_maxsize), queuesize(0), 
     removedClauses(0),
-    forcedRemovedClauses(0), nbThreads(_nbThreads), 
-    whenFullRemoveOlder(opt_whenFullRemoveOlder), fifoSizeByCore(opt_fifoSizeByCore) {
+    forcedRemovedClauses(0), evictedClauses(0), rejectedClauses(0), growths(0), nbThreads(_nbThreads), 
+    whenFullRemoveOlder(opt_whenFullRemoveOlder), fifoSizeByCore(opt_fifoSizeByCore), fifoMaxSizeByCore(opt_fifoMaxSizeByCore),
+    nbActiveReaders(_nbThreads),
+    pushedClauses(0), pushedWords(0), readClauses(0), readWords(0) {
+	if (fifoMaxSizeByCore*_nbThreads > maxcapacity) maxcapacity = fifoMaxSizeByCore*_nbThreads;
 	lastOfThread.growTo(_nbThreads);
+	readerActive.growTo(_nbThreads, true);
 	for(int i=0;i<nbThreads;i++) lastOfThread[i] = _maxsize-1;
 	elems.growTo(maxsize);
+	produced.growTo(_nbThreads, 0);
+	consumed.growTo(_nbThreads*_nbThreads, 0);
+	droppedUnread.growTo(_nbThreads*_nbThreads, 0);
+	maxLag.growTo(_nbThreads, 0);
 } 
 
-ClausesBuffer::ClausesBuffer() : first(0), last(0), maxsize(0), queuesize(0), removedClauses(0), forcedRemovedClauses(0), nbThreads(0),
-                                 whenFullRemoveOlder(opt_whenFullRemoveOlder), fifoSizeByCore(opt_fifoSizeByCore) {}
+ClausesBuffer::ClausesBuffer() : first(0), last(0), maxsize(0), maxcapacity(0), queuesize(0), removedClauses(0), forcedRemovedClauses(0),
+                                 evictedClauses(0), rejectedClauses(0), growths(0), nbThreads(0),
+                                 whenFullRemoveOlder(opt_whenFullRemoveOlder), fifoSizeByCore(opt_fifoSizeByCore), fifoMaxSizeByCore(opt_fifoMaxSizeByCore),
+                                 nbActiveReaders(0),
+                                 pushedClauses(0), pushedWords(0), readClauses(0), readWords(0) {}
 
 void ClausesBuffer::setNbThreads(int _nbThreads) {
     unsigned int _maxsize = fifoSizeByCore*_nbThreads;
     last = _maxsize -1;
     maxsize = _maxsize;
+    maxcapacity = fifoMaxSizeByCore*_nbThreads > _maxsize ? fifoMaxSizeByCore*_nbThreads : _maxsize;
     nbThreads = _nbThreads;
+    nbActiveReaders = _nbThreads;
     lastOfThread.growTo(_nbThreads);
-    for(int i=0;i<nbThreads;i++) lastOfThread[i] = _maxsize-1;
+    readerActive.growTo(_nbThreads);
+    for(int i=0;i<nbThreads;i++) lastOfThread[i] = _maxsize-1, readerActive[i] = true;
     elems.growTo(maxsize);
+    produced.growTo(_nbThreads, 0);
+    consumed.growTo(_nbThreads*_nbThreads, 0);
+    droppedUnread.growTo(_nbThreads*_nbThreads, 0);
+    maxLag.growTo(_nbThreads, 0);
 }
 
 uint32_t ClausesBuffer::getCap() {
@@ -164,19 +188,36 @@ inline uint32_t ClausesBuffer::noCheckPop(uint32_t & index) {
 
 // Return true if the clause was succesfully added
 bool ClausesBuffer::pushClause(int threadId, Clause & c) {
-    if (!whenFullRemoveOlder && (queuesize + c.size() + headerSize >= maxsize))
-	return false; // We need to remove some old clauses
+    int readers = nbActiveReaders - (readerActive[threadId] ? 1 : 0);
+    if (readers == 0 && nbThreads > 1)
+	return false; // All the other threads are paused
+    while (queuesize + c.size() + headerSize >= maxsize && maxsize < maxcapacity)
+	grow();
+    if (!whenFullRemoveOlder) {
+	while (queuesize + c.size() + headerSize >= maxsize && queuesize > 0 && lastIsWorseThan(c)) {
+	    evictedClauses ++;
+	    dropLastClause();
+	}
+	if (queuesize + c.size() + headerSize >= maxsize) {
+	    rejectedClauses ++;
+	    return false; // The old clauses are better
+	}
+    }
     while (queuesize + c.size() + headerSize >= maxsize) { // We need to remove some old clauses
 	forcedRemovedClauses ++;
-	removeLastClause();
+	dropLastClause();
 	assert(queuesize > 0);
     }
     noCheckPush(c.size());
-    noCheckPush(nbThreads>1?nbThreads-1:1);
+    noCheckPush(readers>0?readers:1);
     noCheckPush(threadId);
+    noCheckPush(c.lbd());
     for(int i=0;i<c.size();i++)
 	noCheckPush(toInt(c[i]));
     queuesize += c.size()+headerSize;
+    pushedClauses++;
+    pushedWords += c.size()+headerSize;
+    produced[threadId]++;
     return true;
     //  printf(" -> (%d, %d)\n", first, last);
 }
@@ -213,15 +254,21 @@ bool ClausesBuffer::getClause(int threadId, int & threadOrigin, vec<Lit> & resul
     assert(elems[addIndex(thislast,3)] != ((unsigned int) threadId));
     unsigned int previouslast = thislast;
     bool removeAfter = false;
+    unsigned int lag = first > thislast ? first - thislast - 1 : first + maxsize - thislast - 1;
+    if (lag > maxLag[threadId]) maxLag[threadId] = lag;
     int csize = noCheckPop(thislast);
     removeAfter = (--elems[addIndex(thislast,1)] == 0); // We are sure this is not one of our own clause
     thislast = nextIndex(thislast); // Skips the removeAfter fieldr
     threadOrigin = noCheckPop(thislast);
     assert(threadOrigin != threadId);
+    thislast = nextIndex(thislast); // Skips the lbd
+    consumed[threadOrigin * nbThreads + threadId]++;
     resultClause.clear();
     for(int i=0;i<csize;i++) {
 	resultClause.push(toLit(noCheckPop(thislast)));
     }
+    readClauses++;
+    readWords += csize+headerSize;
     if (last == previouslast && removeAfter) {
 	removeLastClause();
 	thislast = last;
@@ -230,6 +277,69 @@ bool ClausesBuffer::getClause(int threadId, int & threadOrigin, vec<Lit> & resul
     return true;
 }
 
+void ClausesBuffer::dropLastClause() {
+    assert(queuesize > 0);
+    unsigned int origin = elems[addIndex(last,3)];
+    if (elems[addIndex(last,2)] > 0)
+	for(int i=0;i<nbThreads;i++)
+	    if (readerActive[i] && (unsigned int)i != origin && lastOfThread[i] == last)
+		droppedUnread[origin * nbThreads + i]++;
+    removeLastClause();
+}
+
+bool ClausesBuffer::lastIsWorseThan(Clause & c) {
+    unsigned int size = elems[nextIndex(last)], lbd = elems[addIndex(last,4)];
+    return lbd > c.lbd() || (lbd == c.lbd() && size > (unsigned int)c.size());
+}
+
+// Doubles the fifo (up to maxcapacity), with its clauses moved to the beginning
+void ClausesBuffer::grow() {
+    unsigned int newsize = maxsize * 2 < maxcapacity ? maxsize * 2 : maxcapacity;
+    vec<uint32_t> newelems(newsize);
+    unsigned int index = last;
+    for(unsigned int k=0;k<queuesize;k++) {
+	index = nextIndex(index);
+	newelems[k] = elems[index];
+    }
+    for(int i=0;i<nbThreads;i++) {
+	unsigned int d = lastOfThread[i] >= last ? lastOfThread[i] - last : lastOfThread[i] + maxsize - last;
+	lastOfThread[i] = (d == 0 || d > queuesize) ? newsize-1 : d-1;
+    }
+    newelems.moveTo(elems);
+    maxsize = newsize;
+    last = newsize-1;
+    first = queuesize;
+    growths++;
+}
+
+void ClausesBuffer::pauseReader(int threadId) {
+    assert(readerActive[threadId]);
+    readerActive[threadId] = false;
+    nbActiveReaders--;
+
+    unsigned int thislast = lastOfThread[threadId];
+    if ( ( thislast < last && last < first) ||
+	    ( first < thislast && thislast < last ) ||
+	    ( last < first && first < thislast) )
+	thislast = last; // Behind, as in getClause
+    while (nextIndex(thislast) != first) {
+	if (elems[addIndex(thislast,3)] != ((unsigned int)threadId)) {
+	    assert(elems[addIndex(thislast,2)] > 0);
+	    elems[addIndex(thislast,2)]--;
+	}
+	thislast = addIndex(thislast, elems[nextIndex(thislast)] + headerSize);
+    }
+    if (queuesize > 0 && elems[addIndex(last,2)] == 0)
+	removeLastClause();
+}
+
+void ClausesBuffer::resumeReader(int threadId) {
+    assert(!readerActive[threadId]);
+    readerActive[threadId] = true;
+    nbActiveReaders++;
+    lastOfThread[threadId] = first == 0 ? maxsize-1 : first-1;
+}
+
 
 //=================================================================================================
 
@@ -60,20 +60,35 @@ namespace Glucose {
     // index : size clause
     // index + 1 : nbSeen
     // index + 2 : threadId
-    // index + 3 : .. index + 3 + size : Lit of clause
+    // index + 3 : lbd
+    // index + 4 : .. index + 4 + size : Lit of clause
     class ClausesBuffer {
 	vec<uint32_t>  elems;
 	unsigned int     first;
 	unsigned int	 last;
 	unsigned int     maxsize;
+	unsigned int     maxcapacity; // maxsize doubles up to this size when the fifo is full
 	unsigned int     queuesize; // Number of current elements (must be < maxsize !)
 	unsigned int     removedClauses;
 	unsigned int     forcedRemovedClauses;
-        static const int  headerSize = 3;
+	unsigned int     evictedClauses;  // Removed before being read by all threads, for a better clause
+	unsigned int     rejectedClauses; // Not pushed: the fifo was full of better clauses
+	unsigned int     growths;
+        static const int  headerSize = 4;
 	int       nbThreads;
 	bool      whenFullRemoveOlder;
 	unsigned int fifoSizeByCore;
+	unsigned int fifoMaxSizeByCore;
 	vec<unsigned int> lastOfThread; // Last value for a thread 
+	vec<char> readerActive;         // False while a thread is retired: it reads nothing and nothing waits for it
+	int       nbActiveReaders;
+	uint64_t pushedClauses, pushedWords; // Traffic written to the fifo (headers included)
+	uint64_t readClauses, readWords;     // Traffic read from the fifo by all threads
+	// By thread, and by pair of threads (origin * nbThreads + reader)
+	vec<uint64_t> produced;
+	vec<uint64_t> consumed;
+	vec<uint64_t> droppedUnread;
+	vec<unsigned int> maxLag; // Most words a thread had left to read
 
 	public:
 	ClausesBuffer(int _nbThreads, unsigned int _maxsize);
@@ -83,6 +98,9 @@ namespace Glucose {
 	unsigned int nextIndex(unsigned int i);
 	unsigned int addIndex(unsigned int i, unsigned int a); 
 	void removeLastClause(); 
+	void dropLastClause(); // removeLastClause, counting the threads that had not read it
+	bool lastIsWorseThan(Clause & c); // Quality of the oldest clause (LBD, then size)
+	void grow();
 	   
 	void noCheckPush(uint32_t x);
 	uint32_t noCheckPop(unsigned int & index);
@@ -90,16 +108,28 @@ namespace Glucose {
 	// Return true if the clause was succesfully added
         bool pushClause(int threadId, Clause & c);
         bool getClause(int threadId, int & threadOrigin, vec<Lit> & resultClause, bool firstFound = false); 
+
+	// A paused thread no longer holds the clauses it has not read yet; once resumed, it only reads
+	// the clauses pushed after
+	void pauseReader(int threadId);
+	void resumeReader(int threadId);
 	
 	int maxSize() const {return maxsize;}
+	uint64_t nbPushedClauses() const {return pushedClauses;}
+	uint64_t nbPushedWords() const {return pushedWords;}
+	uint64_t nbReadClauses() const {return readClauses;}
+	uint64_t nbReadWords() const {return readWords;}
+	unsigned int nbRemovedClauses() const {return removedClauses;}
+	unsigned int nbForcedRemovedClauses() const {return forcedRemovedClauses;}
+	unsigned int nbEvictedClauses() const {return evictedClauses;}
+	unsigned int nbRejectedClauses() const {return rejectedClauses;}
+	unsigned int nbGrowths() const {return growths;}
+	int maxCapacity() const {return maxcapacity;}
+	uint64_t nbProduced(int origin) const {return produced[origin];}
+	uint64_t nbConsumed(int origin, int reader) const {return consumed[origin * nbThreads + reader];}
+	uint64_t nbDroppedUnread(int origin, int reader) const {return droppedUnread[origin * nbThreads + reader];}
+	unsigned int maxLagOf(int reader) const {return maxLag[reader];}
         uint32_t getCap();
-	void growTo(int size) {
-	    assert(0); // Not implemented (essentially for efficiency reasons)
-	    elems.growTo(size); 
-	    first=0; maxsize=size; queuesize = 0;last = 0;
-	    for(int i=0;i<size;i++) elems[i]=0; 
-	}
-
 	void fastclear() {first = 0; last = 0; queuesize=0; } 
 
 	int  size(void)    { return queuesize; }
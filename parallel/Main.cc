@@ -57,6 +57,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "utils/ParseUtils.h"
 #include "utils/Options.h"
 #include "core/Dimacs.h"
+#include "core/GlucoseLiteralAdapter.h"
+#include "core/ModelWriter.h"
 #include "core/SolverTypes.h"
 
 #include "simp/SimpSolver.h"
@@ -84,6 +86,9 @@ static void SIGINT_exit(int signum) {
         printf("\n"); printf("*** INTERRUPTED ***\n"); }
     _exit(1); }
 
+// Prints the progress of the threads without stopping them
+static void SIGUSR1_stats(int signum) { pmsolver->requestStats(); }
+
 
 //=================================================================================================
 // Main:
@@ -106,17 +111,40 @@ int main(int argc, char** argv)
         //
         IntOption    verb   ("MAIN", "verb",   "Verbosity level (0=silent, 1=some, 2=more).", 1, IntRange(0, 2));
         BoolOption   mod   ("MAIN", "model",   "show model.", false);
+        StringOption mod_fmt("MAIN", "model-format", "Format of the model, in the result file or shown: text, binary or bitset (see core/ModelWriter.h).", "text");
         IntOption    vv  ("MAIN", "vv",   "Verbosity every vv conflicts", 10000, IntRange(1,INT32_MAX));
         IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds.\n", INT32_MAX, IntRange(0, INT32_MAX));
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
+        StringOption metrics("MAIN", "metrics","If given, publish live counters of the search of each thread in this file (mapped in shared memory, see utils/Metrics.h).");
+
+        BoolOption   linear_sym_gens("MAIN", "linear-sym-gens", "Use a linear number of generators for row interchangeability.", false);
+        BoolOption   opt_bliss      ("SYM", "bliss",  "Parse sym file in bliss", false);
+        BoolOption   opt_breakid    ("SYM", "breakid","PArse sym file in breakid format", false);
+        BoolOption   opt_static_sbp ("SYM", "static-sbp", "Add lex-leader symmetry breaking clauses before search, instead of SEL and ESBP", false);
+        IntOption    opt_sbp_size   ("SYM", "sbp-size", "Number of variables constrained by the lex-leader clauses of each generator", 50, IntRange(1, INT32_MAX));
+        BoolOption   opt_detect_rows("SYM", "detect-rows", "Detect interchangeable rows among the generators, and add the swaps of all their rows", false);
+        DoubleOption opt_rows_time  ("SYM", "rows-time", "Time limit of the detection of interchangeable rows (in seconds)", 10, DoubleRange(0, true, HUGE_VAL, true));
         
         parseOptions(argc, argv, true);
 
+        if (opt_bliss && opt_breakid) {
+            printf("c ERROR! Cannot use both Bliss and BreakID formats\n");
+            exit(1);
+        }
+
+        ModelWriter::Format model_format;
+        if (!ModelWriter::parseFormat(mod_fmt, model_format)) {
+            printf("c ERROR! Unknown model format: %s\n", (const char*)mod_fmt);
+            exit(1);
+        }
+
 	MultiSolvers msolver;
         pmsolver = & msolver;
         msolver.setVerbosity(verb);
         msolver.setVerbEveryConflicts(vv);
         msolver.setShowModel(mod);
+        if (metrics)
+            msolver.setMetricsFile((const char*)metrics);
 
         double initial_time = cpuTime();
 
@@ -124,6 +152,7 @@ int main(int argc, char** argv)
         // interrupts:
 	signal(SIGINT, SIGINT_exit);
         signal(SIGXCPU,SIGINT_exit);
+        signal(SIGUSR1,SIGUSR1_stats);
 
         // Set limit on CPU-time:
         if (cpu_lim != INT32_MAX){
@@ -159,6 +188,41 @@ int main(int argc, char** argv)
         
         parse_DIMACS(in, msolver);
         gzclose(in);
+        const int nbInputVars = msolver.nVars(); // The model shows these ones, not the lex-leader variables
+
+        // Symmetry generators are read by the first solver, and duplicated in its clones
+        int nbLexLeader = -1;
+        int nbRowSwaps = -1;
+        if (argc > 1 && (opt_bliss || opt_breakid)) {
+            std::string cnf_file = argv[1];
+            std::string sym_file = cnf_file + (opt_bliss ? ".bliss" : ".sym");
+            cosy::SymmetryReader reader = opt_bliss ? cosy::SymmetryReader::SAUCY_SYM : cosy::SymmetryReader::BREAKID_SYM;
+            gzFile in_sym = gzopen(sym_file.c_str(), "rb");
+            if (in_sym != NULL && opt_static_sbp) {
+                // The formula is not symmetric anymore: the threads use neither SEL nor ESBP
+                gzclose(in_sym);
+                std::unique_ptr<cosy::LiteralAdapter<Lit>> adapter(new GlucoseLiteralAdapter());
+                cosy::SymmetryController<Lit> symmetry(cnf_file, sym_file, reader, adapter);
+                if (opt_detect_rows)
+                    symmetry.detectInterchangeability(opt_rows_time);
+                nbLexLeader = add_LEXLEADER(symmetry, msolver, msolver.getPrimarySolver()->esbpOrder, opt_sbp_size);
+            } else if (in_sym != NULL) {
+                if (opt_breakid)
+                    parse_SYMMETRY(in_sym, *msolver.getPrimarySolver(), linear_sym_gens);
+                else
+                    parse_SYMMETRY_BLISS(in_sym, *msolver.getPrimarySolver());
+                gzclose(in_sym);
+                if (opt_detect_rows) {
+                    // The threads using ESBP detect the rows again in their own controller
+                    std::unique_ptr<cosy::LiteralAdapter<Lit>> adapter(new GlucoseLiteralAdapter());
+                    cosy::SymmetryController<Lit> symmetry(cnf_file, sym_file, reader, adapter);
+                    symmetry.detectInterchangeability(opt_rows_time);
+                    nbRowSwaps = add_ROW_SWAPS(symmetry, *msolver.getPrimarySolver(), linear_sym_gens);
+                }
+                msolver.setSymmetrySource(cnf_file, sym_file, reader, opt_detect_rows ? (double)opt_rows_time : -1);
+            } else
+                printf("c Did not find %s symmetry file. Assuming no symmetry is provided.\n", sym_file.c_str());
+        }
         
 
 	
@@ -166,7 +230,12 @@ int main(int argc, char** argv)
 
         if (msolver.verbosity() > 0){
             printf("c |  Number of variables:  %12d                                                                   |\n", msolver.nVars());
-            printf("c |  Number of clauses:    %12d                                                                   |\n", msolver.nClauses()); }
+            printf("c |  Number of clauses:    %12d                                                                   |\n", msolver.nClauses());
+            printf("c |  Number of sym generators: %8d                                                                   |\n", msolver.getPrimarySolver()->nGenerators());
+            if (nbRowSwaps >= 0)
+                printf("c |  Number of row swap generators: %8d                                                              |\n", nbRowSwaps);
+            if (nbLexLeader >= 0)
+                printf("c |  Number of lex-leader clauses: %8d                                                               |\n", nbLexLeader); }
         
         double parsed_time = cpuTime();
         if (msolver.verbosity() > 0){
@@ -211,33 +280,20 @@ int main(int argc, char** argv)
             msolver.printFinalStats();
             printf("\n"); }
 
-	//-------------- Result is put in a external file
-     	/* I must admit I have to print the model of one thread... But which one? FIXME !!
-	  if (res != NULL){  
-	  if (ret == l_True){
-	    fprintf(res, "SAT\n");
-	    for (int i = 0; i < S.nVars(); i++)
-	      if (S.model[i] != l_Undef)
-		fprintf(res, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
-	    fprintf(res, " 0\n");
-	  }else if (ret == l_False)
-	    fprintf(res, "UNSAT\n");
-	  else
-	    fprintf(res, "INDET\n");
-	  fclose(res);
-	
-	//-------------- Want certified output
-        } else { 
-	*/
 	  printf(ret == l_True ? "s SATISFIABLE\n" : ret == l_False ? "s UNSATISFIABLE\n" : "s INDETERMINATE\n");
-	  
-	  if(msolver.getShowModel() && ret==l_True) {
-	    printf("v ");
-	    for (int i = 0; i < msolver.model.size() ; i++)
-	      if (msolver.model[i] != l_Undef)
-		printf("%s%s%d", (i==0)?"":" ", (msolver.model[i]==l_True)?"":"-", i+1);
-	    printf(" 0\n");
-	  }
+
+	//-------------- Result is put in a external file (the model of the winner, see MultiSolvers::model)
+	  if (res != NULL){
+	    if (ret == l_True){
+	      fprintf(res, "SAT\n");
+	      ModelWriter(res).write(msolver.model, nbInputVars, model_format);
+	    }else if (ret == l_False)
+	      fprintf(res, "UNSAT\n");
+	    else
+	      fprintf(res, "INDET\n");
+	    fclose(res);
+	  } else if(msolver.getShowModel() && ret==l_True)
+	    ModelWriter(stdout).write(msolver.model, nbInputVars, model_format, "v ");
 
      
     
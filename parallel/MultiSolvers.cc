@@ -55,6 +55,12 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <errno.h>
 #include <string.h>
 #include "parallel/SolverConfiguration.h"
+#include "core/GlucoseLiteralAdapter.h"
+#include <sys/wait.h>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/prctl.h>
+#endif
 
 using namespace Glucose;
 
@@ -64,11 +70,19 @@ extern const char* _cunstable;
 static IntOption opt_nbsolversmultithreads (_parallel, "nthreads", "Number of core threads for syrup (0 for automatic)", 0);
 static IntOption opt_maxnbsolvers (_parallel, "maxnbthreads", "Maximum number of core threads to ask for (when nbthreads=0)", 4);
 static IntOption opt_maxmemory    (_parallel, "maxmemory", "Maximum memory to use (in Mb, 0 for no software limit)", 3000);
-static IntOption opt_statsInterval (_parallel, "statsinterval", "Seconds (real time) between two stats reports", 5);
+static IntOption opt_statsInterval (_parallel, "statsinterval", "Seconds (real time) between two stats reports", 5, IntRange(1, INT32_MAX));
+static IntOption opt_procs (_parallel, "procs", "Number of solver processes of nthreads threads each, with their own memory, sharing clauses through shared memory (0: one by NUMA node)", 1, IntRange(0, INT32_MAX));
+static IntOption opt_memSample (_parallel, "memsample", "Milliseconds (real time) between two samples of the memory used (see maxmemory)", 200, IntRange(1, INT32_MAX));
+static BoolOption opt_numaBind (_parallel, "numa-bind", "Pin each solver thread to a cpu, spreading threads over the NUMA nodes (Linux only)", false);
+static BoolOption opt_parallelClones (_parallel, "parallel-clones", "Build the clones of the first solver concurrently, each on the cpu of its thread with -numa-bind", true);
+static BoolOption opt_scaleThreads (_parallel, "scale-threads", "Retire threads when the memory exceeds maxmemory (before the panic mode), and resume them when it is available again", true);
+static IntOption opt_minThreads (_parallel, "minthreads", "Minimum number of threads kept running when the memory exceeds maxmemory", 1, IntRange(1, INT32_MAX));
+static IntOption opt_resumeMemory (_parallel, "resume-memory", "Memory (in percent of maxmemory) under which a retired thread is resumed", 70, IntRange(0, 100));
 //
 // Shared with ClausesBuffer.cc
 BoolOption opt_whenFullRemoveOlder (_parallel, "removeolder", "When the FIFO for exchanging clauses between threads is full, remove older clauses", false);
 IntOption opt_fifoSizeByCore(_parallel, "fifosize", "Size of the FIFO structure for exchanging clauses between threads, by threads", 100000);
+IntOption opt_fifoMaxSizeByCore(_parallel, "fifomaxsize", "Size up to which the FIFO grows when it is full, by threads (fifosize or less: fixed size)", 400000);
 //
 // Shared options with Solver.cc 
 BoolOption    opt_dontExportDirectReusedClauses (_cunstable, "reusedClauses",    "Don't export directly reused clauses", false);
@@ -84,11 +98,6 @@ static inline double cpuTime(void) {
 return (double)ru.ru_utime.tv_sec + (double)ru.ru_utime.tv_usec / 1000000; }
 
 
-void MultiSolvers::informEnd(lbool res) {
-  result = res;
-  pthread_cond_broadcast(&cfinished);
-}
-
 MultiSolvers::MultiSolvers(ParallelSolver *s):
   ok (true)
   , maxnbthreads(4), nbthreads(opt_nbsolversmultithreads), nbsolvers(opt_nbsolversmultithreads)
@@ -105,6 +114,11 @@ MultiSolvers::MultiSolvers(ParallelSolver *s):
   , maxmemory(opt_maxmemory), maxnbsolvers(opt_maxnbsolvers)
   , verb(0) , verbEveryConflicts(10000)
   , numvar(0), numclauses(0)
+  , hasSymmetrySource(false)
+  , symReader(cosy::SymmetryReader::BREAKID_SYM)
+  , symRowsTimeLimit(-1)
+  , nbprocs(1), procIndex(0), firstThread(0), ring(NULL)
+  , statsRequested(0)
 
 {
     result = l_Undef;
@@ -135,18 +149,56 @@ MultiSolvers::MultiSolvers() : MultiSolvers(new ParallelSolver(-1)) {
 }
 
 MultiSolvers::~MultiSolvers()
-{}
+{
+    delete ring;
+}
 
 /**
  * Generate All solvers
+ *
+ * The copy constructors only read solver 0, so the clones are built concurrently. With -numa-bind,
+ * each clone is built on the cpu of the thread that will run it: its memory is allocated on first
+ * touch on the right NUMA node.
  */
 
+static bool bindToCpu(pthread_t thread, int cpu);
+
+struct CloneJob {
+    const ParallelSolver *source;
+    ParallelSolver *clone;
+    int cpu;       // -1 to leave the builder thread unbound
+    bool threaded; // false if the builder thread could not be created
+};
+
+static void *cloneLaunch(void *arg) {
+    CloneJob *job = (CloneJob*)arg;
+    if (job->cpu >= 0)
+	(void)bindToCpu(pthread_self(), job->cpu);
+    job->clone = (ParallelSolver*)job->source->clone();
+    return NULL;
+}
+
 void MultiSolvers::generateAllSolvers() {
     assert(solvers[0] != NULL);
     assert(allClonesAreBuilt==0);
 
+    vec<CloneJob> jobs(nbsolvers);
+    vec<pthread_t> builders(nbsolvers);
     for(int i=1;i<nbsolvers;i++) {
-	ParallelSolver *s  = (ParallelSolver*)solvers[0]->clone();
+	jobs[i].source = solvers[0];
+	jobs[i].cpu = opt_numaBind ? cpuOfThread(i) : -1;
+	jobs[i].threaded = opt_parallelClones && pthread_create(&builders[i], NULL, &cloneLaunch, &jobs[i]) == 0;
+	if (!jobs[i].threaded) {
+	    jobs[i].cpu = -1;
+	    cloneLaunch(&jobs[i]);
+	}
+    }
+    for(int i=1;i<nbsolvers;i++)
+	if (jobs[i].threaded)
+	    pthread_join(builders[i], NULL);
+
+    for(int i=1;i<nbsolvers;i++) {
+	ParallelSolver *s  = jobs[i].clone;
 	solvers.push(s);
 	s->verbosity = 0; // No reportf in solvers... All is done in MultiSolver
 	s->setThreadNumber(i);
@@ -160,6 +212,32 @@ void MultiSolvers::generateAllSolvers() {
     allClonesAreBuilt = 1;
 }
 
+/**
+ * Symmetry controllers of the threads using ESBP
+ */
+
+void MultiSolvers::setSymmetrySource(const std::string& cnf_file, const std::string& sym_file, cosy::SymmetryReader reader,
+                                     double rows_time_limit) {
+    hasSymmetrySource = true;
+    symCNFFile = cnf_file;
+    symFile = sym_file;
+    symReader = reader;
+    symRowsTimeLimit = rows_time_limit;
+    symAdapter = std::unique_ptr<cosy::LiteralAdapter<Lit>>(new GlucoseLiteralAdapter());
+}
+
+bool MultiSolvers::attachSymmetryController(int i) {
+    if (!hasSymmetrySource)
+        return false;
+    ParallelSolver *s = solvers[i];
+    s->symmetry = std::unique_ptr<cosy::SymmetryController<Lit>>
+        (new cosy::SymmetryController<Lit>(symCNFFile, symFile, symReader, symAdapter));
+    if (symRowsTimeLimit >= 0)
+        s->symmetry->detectInterchangeability(symRowsTimeLimit);
+    s->notifyCNFUnits();
+    return true;
+}
+
 /**
  * Choose solver for threads i (if no given in command line see above)
  */
@@ -253,6 +331,203 @@ bool MultiSolvers::eliminate() {
 }
 
 
+/**
+ * NUMA placement of the solver threads
+ *
+ * Threads are dealt round-robin over the NUMA nodes listed in sysfs (thread i goes to node
+ * i % #nodes), then over the cpus of that node. With -parallel-clones, each clone is built by
+ * a thread pinned to the same cpu (see generateAllSolvers): its clause arena, watches and
+ * learnt clauses are first touched there, so a solver keeps most of its memory on its local
+ * node and only the blackboard traffic crosses the sockets.
+ *
+ * With several processes (see startProcesses), each process stays on one node and its threads
+ * are dealt over the cpus of that node.
+ */
+
+#ifdef __linux__
+// Parses a sysfs cpu list like "0-3,8-11"
+static void parseCpuList(const char *str, vec<int>& cpus) {
+    while (*str) {
+	char *end;
+	long lo = strtol(str, &end, 10), hi = lo;
+	if (end == str) break;
+	if (*end == '-') { str = end + 1; hi = strtol(str, &end, 10); }
+	for (long c = lo; c <= hi; c++) cpus.push((int)c);
+	str = (*end == ',') ? end + 1 : end;
+	if (*str == '\n') break;
+    }
+}
+
+static void numaNodesCpus(vec<vec<int> >& nodes) {
+    char path[64], buf[4096];
+    for (int n = 0; ; n++) {
+	sprintf(path, "/sys/devices/system/node/node%d/cpulist", n);
+	FILE *f = fopen(path, "r");
+	if (f == NULL) break;
+	if (fgets(buf, sizeof(buf), f) != NULL) {
+	    nodes.push();
+	    parseCpuList(buf, nodes.last());
+	    if (nodes.last().size() == 0) nodes.pop();
+	}
+	fclose(f);
+    }
+    if (nodes.size() == 0) { // No NUMA information: a single node with all the cpus
+	nodes.push();
+	long nbcpus = sysconf(_SC_NPROCESSORS_ONLN);
+	for (int c = 0; c < nbcpus; c++) nodes.last().push(c);
+    }
+}
+
+static bool bindToCpu(pthread_t thread, int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread, sizeof(cpu_set_t), &set) == 0;
+}
+
+int MultiSolvers::nodeOfThread(int i) {
+    if (numaNodes.size() == 0)
+	numaNodesCpus(numaNodes);
+    return nbprocs > 1 ? procIndex % numaNodes.size() : i % numaNodes.size();
+}
+
+int MultiSolvers::cpuOfThread(int i) {
+    const vec<int>& cpus = numaNodes[nodeOfThread(i)];
+    if (nbprocs > 1) // The processes on the same node share its cpus
+	return cpus[(procIndex / numaNodes.size() * nbsolvers + i) % cpus.size()];
+    return cpus[(i / numaNodes.size()) % cpus.size()];
+}
+
+void MultiSolvers::bindThreads() {
+    for (int i = 0; i < nbsolvers; i++) {
+	int cpu = cpuOfThread(i);
+	if (!bindToCpu(*threads[i], cpu)) {
+	    if (verb >= 1) printf("c Unable to bind thread %d to cpu %d\n", i, cpu);
+	} else if (verb >= 1)
+	    printf("c Thread %d bound to cpu %d (node %d)\n", i, cpu, nodeOfThread(i));
+    }
+}
+#else
+static bool bindToCpu(pthread_t thread, int cpu) { return false; }
+int MultiSolvers::nodeOfThread(int i) { return 0; }
+int MultiSolvers::cpuOfThread(int i) { return -1; }
+void MultiSolvers::bindThreads() {}
+#endif
+
+/**
+ * Processes
+ *
+ * With -procs, the solver runs several processes of nbsolvers threads each. They are forked once
+ * the formula is loaded, before the clones are built: each process builds its clones on the cpus of
+ * its NUMA node (process p goes to node p % #nodes), and keeps its heap and clause allocators there.
+ * The threads of a process share through its ClausesBuffer, then with the other processes through
+ * a SharedRing, the only memory written by several nodes. The threads are diversified over all the
+ * processes (see SolverConfiguration). Process 0 prints everything: the others only share, and exit
+ * once the answer is known (see endProcesses).
+ */
+
+void MultiSolvers::adjustNumberOfProcesses() {
+    nbprocs = opt_procs;
+    if (nbprocs == 0) { // One by NUMA node
+#ifdef __linux__
+	if (numaNodes.size() == 0)
+	    numaNodesCpus(numaNodes);
+	nbprocs = numaNodes.size();
+#else
+	nbprocs = 1;
+#endif
+    }
+}
+
+void MultiSolvers::startProcesses() {
+    ring = new SharedRing();
+    if (!ring->create(nbprocs, nbsolvers, nVars(), (uint64_t)opt_fifoMaxSizeByCore * nbprocs * nbsolvers, opt_whenFullRemoveOlder)) {
+	printf("c WARNING! Could not map the memory shared by the processes, running a single process.\n");
+	delete ring;
+	ring = NULL;
+	nbprocs = 1;
+	return;
+    }
+    if (verb >= 1)
+	printf("c %d processes of %d threads, sharing between processes through a fifo of %" PRIu64" ints\n",
+	       nbprocs, nbsolvers, (uint64_t)opt_fifoMaxSizeByCore * nbprocs * nbsolvers);
+
+    fflush(NULL); // Else the children print the buffered output again
+    pid_t parent = getpid();
+    for (int p = 1; p < nbprocs; p++) {
+	pid_t pid = fork();
+	if (pid == 0) {
+#ifdef __linux__
+	    prctl(PR_SET_PDEATHSIG, SIGKILL); // Killed with process 0...
+	    if (getppid() != parent)          // ...even if it died before prctl
+		_exit(1);
+#endif
+	    if (freopen("/dev/null", "w", stdout) == NULL) {} // stdout is closed anyway
+	    procIndex = p;
+	    children.clear();
+	    break;
+	}
+	if (pid < 0) { // Nothing waits for the missing processes
+	    printf("c WARNING! Could not fork process %d, running %d processes.\n", p, p);
+	    for (int t = p * nbsolvers; t < nbprocs * nbsolvers; t++)
+		ring->pauseReader(t);
+	    nbprocs = p;
+	    break;
+	}
+	children.push(pid);
+    }
+    firstThread = procIndex * nbsolvers;
+    sharedcomp->setRing(ring, procIndex);
+
+#ifdef __linux__
+    // The clone builders and the solver threads inherit the cpus of the node
+    int node = nodeOfThread(0);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int i = 0; i < numaNodes[node].size(); i++)
+	CPU_SET(numaNodes[node][i], &set);
+    if (sched_setaffinity(0, sizeof(cpu_set_t), &set) != 0 && verb >= 1)
+	printf("c Unable to bind process %d to node %d\n", procIndex, node);
+#endif
+}
+
+// The winner publishes its answer before it exits: process 0 takes it, then stops the others
+void MultiSolvers::endProcesses() {
+    if (procIndex > 0) { // Never returns to main
+	if (sharedcomp->winner() != NULL)
+	    ring->publish(result, model);
+	_exit(0);
+    }
+
+    int alive = children.size();
+    bool stopped = false;
+    while (alive > 0) {
+	if (!stopped && (sharedcomp->winner() != NULL || ring->published())) {
+	    for (int i = 0; i < children.size(); i++)
+		if (children[i] > 0)
+		    kill(children[i], SIGKILL);
+	    stopped = true;
+	}
+	int status;
+	pid_t pid = waitpid(-1, &status, 0);
+	if (pid < 0) {
+	    if (errno == EINTR) continue;
+	    break;
+	}
+	for (int i = 0; i < children.size(); i++)
+	    if (children[i] == pid)
+		children[i] = -1, alive--;
+    }
+
+    if (sharedcomp->winner() == NULL && ring->published()) {
+	result = ring->status();
+	if (result == l_True)
+	    ring->getModel(model);
+	if (verb >= 1)
+	    printf("c Process %d (thread %d) answered first\n", ring->winnerProcess(), ring->winnerThread());
+    }
+}
+
 // TODO: Use a template here
 void *localLaunch(void*arg) {
   ParallelSolver* s = (ParallelSolver*)arg;
@@ -263,7 +538,6 @@ void *localLaunch(void*arg) {
 }
 
 
-#define MAXIMUM_SLEEP_DURATION 5
 void MultiSolvers::printStats() {
 	static int nbprinted = 1;
 	double cpu_time = cpuTime();
@@ -375,6 +649,72 @@ void MultiSolvers::printFinalStats() {
     }
     printf("| %15" PRIu64" |\n", removedimported);
 
+    printf("c | Imp dups      ");
+    uint64_t importDuplicates = 0;
+    for(int i=0;i<solvers.size();i++) {
+	printf("| %10" PRIu64" ", solvers[i]->nbImportDuplicates);
+        importDuplicates += solvers[i]->nbImportDuplicates;
+    }
+    printf("| %15" PRIu64" |\n", importDuplicates);
+
+    printf("c | Imp subsumed  ");
+    uint64_t importSubsumed = 0;
+    for(int i=0;i<solvers.size();i++) {
+	printf("| %10" PRIu64" ", solvers[i]->nbImportSubsumed);
+        importSubsumed += solvers[i]->nbImportSubsumed;
+    }
+    printf("| %15" PRIu64" |\n", importSubsumed);
+
+    printf("c | Imp in search ");
+    uint64_t importedInSearch = 0;
+    for(int i=0;i<solvers.size();i++) {
+	printf("| %10" PRIu64" ", solvers[i]->nbImportedInSearch);
+        importedInSearch += solvers[i]->nbImportedInSearch;
+    }
+    printf("| %15" PRIu64" |\n", importedInSearch);
+
+    printf("c | Imp assigning ");
+    uint64_t importedAssigning = 0;
+    for(int i=0;i<solvers.size();i++) {
+	printf("| %10" PRIu64" ", solvers[i]->nbImportedAssigning);
+        importedAssigning += solvers[i]->nbImportedAssigning;
+    }
+    printf("| %15" PRIu64" |\n", importedAssigning);
+
+    printf("c | Imp backjumps ");
+    uint64_t importBacktracks = 0;
+    for(int i=0;i<solvers.size();i++) {
+	printf("| %10" PRIu64" ", solvers[i]->nbImportBacktracks);
+        importBacktracks += solvers[i]->nbImportBacktracks;
+    }
+    printf("| %15" PRIu64" |\n", importBacktracks);
+
+    if (hasSymmetrySource) {
+        printf("c | Exp images    ");
+        uint64_t exportedImages = 0;
+        for(int i=0;i<solvers.size();i++) {
+            printf("| %10" PRIu64" ", solvers[i]->nbExportedImages);
+            exportedImages += solvers[i]->nbExportedImages;
+        }
+        printf("| %15" PRIu64" |\n", exportedImages);
+
+        printf("c | Imp images    ");
+        uint64_t importedImages = 0;
+        for(int i=0;i<solvers.size();i++) {
+            printf("| %10" PRIu64" ", solvers[i]->nbImportedImages);
+            importedImages += solvers[i]->nbImportedImages;
+        }
+        printf("| %15" PRIu64" |\n", importedImages);
+    }
+
+    printf("c | Retirements   ");
+    uint64_t retirements = 0;
+    for(int i=0;i<solvers.size();i++) {
+	printf("| %10" PRIu64" ", solvers[i]->nbRetirements);
+        retirements += solvers[i]->nbRetirements;
+    }
+    printf("| %15" PRIu64" |\n", retirements);
+
     printf("c | Blocked Reuse ");
     uint64_t blockedreused = 0;
     for(int i=0;i<solvers.size();i++) {
@@ -409,6 +749,29 @@ void MultiSolvers::printFinalStats() {
     }
     printf("|                 |\n"); 
 
+    if (hasSymmetrySource) {
+        static const char* symModeNames[NB_SYM_MODES] = {"none", "SEL", "ESBP", "SEL+ESBP"};
+        printf("c | Sym mode      ");
+        for(int i=0;i<solvers.size();i++) {
+            printf("| %10s ", symModeNames[solvers[i]->symmetryMode()]);
+        }
+        printf("|                 |\n");
+
+        printf("c | Sym infer     ");
+        uint64_t inferences = 0;
+        for(int i=0;i<solvers.size();i++) {
+            printf("| %10" PRIu64" ", solvers[i]->symmetryInferences());
+            inferences += solvers[i]->symmetryInferences();
+        }
+        printf("| %15" PRIu64" |\n", inferences);
+
+        printf("c | Sym switches  ");
+        for(int i=0;i<solvers.size();i++) {
+            printf("| %10" PRIu64" ", solvers[i]->nbSymSwitches);
+        }
+        printf("|                 |\n");
+    }
+
 
     int winner = -1;
    for(int i=0;i<solvers.size();i++) {
@@ -447,6 +810,7 @@ int sum = 0;
 // Well, all those parameteres are just naive guesses... No experimental evidences for this.
 void MultiSolvers::adjustParameters() {
     SolverConfiguration::configure(this,nbsolvers);
+    SolverConfiguration::configureSymmetry(this,nbsolvers);
 }
 
 void MultiSolvers::adjustNumberOfCores() {
@@ -466,15 +830,53 @@ void MultiSolvers::adjustNumberOfCores() {
   }
 }
 
+/**
+ * Thread scaling
+ *
+ * Above maxmemory, the last running thread is retired (one at a time, see solve): it sheds its learnt
+ * clauses and sleeps (see ParallelSolver::retire). The panic mode only starts with -minthreads
+ * threads left. Below resume-memory percent of maxmemory, a retired thread is resumed.
+ */
+
+void MultiSolvers::scaleThreads(double mem) {
+    if (maxmemory == 0)
+	return;
+    if (mem > maxmemory) {
+	int running = 0, last = -1;
+	for (int i = 0; i < nbsolvers; i++)
+	    if (!solvers[i]->retired) running++, last = i;
+	if (opt_scaleThreads && running > opt_minThreads) {
+	    printf("c ** Retiring thread %d due to memory limitations (%d threads left)\n", last, running - 1);
+	    solvers[last]->requestRetirement();
+	} else if (!sharedcomp->panicMode)
+	    printf("c ** reduceDB switching to Panic Mode due to memory limitations !\n"), sharedcomp->panicMode = true;
+    } else if (mem < (double)maxmemory * opt_resumeMemory / 100) {
+	for (int i = 0; i < nbsolvers; i++)
+	    if (solvers[i]->retired) {
+		printf("c ** Resuming thread %d (memory %.2fMb)\n", i, mem);
+		solvers[i]->resume();
+		break;
+	    }
+    }
+}
+
 lbool MultiSolvers::solve() {
   pthread_attr_t thAttr; 
   int i; 
 
   adjustNumberOfCores();
   sharedcomp->setNbThreads(nbsolvers); 
+  adjustNumberOfProcesses();
+  if (!metricsPath.empty() && !metricsFile.open(metricsPath.c_str(), nbprocs * nbsolvers)) // One slot by thread of all the processes
+    printf("c WARNING! Could not create the metrics file %s, running without it.\n", metricsPath.c_str());
+  if (nbprocs > 1)
+    startProcesses();
   if(verb>=1) 
     printf("c |  Generating clones                                                                                    |\n"); 
   generateAllSolvers();
+  if (metricsFile.isOpen())
+    for (i = 0; i < nbsolvers; i++)
+      solvers[i]->metrics = metricsFile.slot(firstThread + i);
   if(verb>=1) {
     printf("c |  all clones generated. Memory = %6.2fMb.                                                             |\n", memUsed());
     printf("c ========================================================================================================|\n");
@@ -497,32 +899,61 @@ lbool MultiSolvers::solve() {
     solvers[i]->pcfinished = &cfinished;
     pthread_create(threads[i], &thAttr, &localLaunch, (void*)solvers[i]); 
   }
+  if (opt_numaBind)
+      bindThreads();
   
-  bool done = false;
+  // Coordinator: sleeps until a thread ends (see ParallelSolver::solve_), the next memory sample or
+  // the next stats report. The threads are scaled when the memory crosses maxmemory or resume-memory,
+  // then at most once by stats interval while it stays above (or below).
+  double now = realTime();
+  double nextStats = now + opt_statsInterval, nextSample = now, nextScaling = now;
+  int memoryZone = 0; // 0: below resume-memory, 1: between, 2: above maxmemory
   
   (void)pthread_mutex_lock(&m);
-  while (!done) { 
+  for (;;) {
+    double next = nextStats < nextSample ? nextStats : nextSample;
     struct timespec timeout;
-    time(&timeout.tv_sec);
-    timeout.tv_sec += MAXIMUM_SLEEP_DURATION;
-    timeout.tv_nsec = 0;
-    if (pthread_cond_timedwait(&cfinished, &mfinished, &timeout) != ETIMEDOUT) 
-	    done = true;
-    else 
+    timeout.tv_sec = (time_t)next;
+    timeout.tv_nsec = (long)((next - (double)timeout.tv_sec) * 1000000000);
+    (void)pthread_mutex_lock(&mfinished);
+    while (!sharedcomp->jobFinished() && sharedcomp->nbThreadsEnded() < nbsolvers && !statsRequested)
+      if (pthread_cond_timedwait(&cfinished, &mfinished, &timeout) == ETIMEDOUT)
+        break;
+    (void)pthread_mutex_unlock(&mfinished);
+    if (sharedcomp->jobFinished() || sharedcomp->nbThreadsEnded() == nbsolvers)
+      break;
+
+    now = realTime();
+    if (now >= nextStats || statsRequested) {
       printStats();
-
-    float mem = memUsed();
-    if(verb>=1) printf("c Total Memory so far : %.2fMb\n",  mem);
-    if ( (maxmemory > 0) && (mem > maxmemory) && !sharedcomp->panicMode) 
-       printf("c ** reduceDB switching to Panic Mode due to memory limitations !\n"), sharedcomp->panicMode = true;
-    
+      if (verb >= 1) printf("c Total Memory so far : %.2fMb\n", memUsed());
+      if (now >= nextStats) nextStats = now + opt_statsInterval;
+      statsRequested = 0;
+    }
+    if (now >= nextSample) {
+      nextSample = now + (double)opt_memSample / 1000;
+      double mem = memUsed();
+      int zone = maxmemory > 0 && mem > maxmemory ? 2 : mem < (double)maxmemory * opt_resumeMemory / 100 ? 0 : 1;
+      if (zone != memoryZone || (zone != 1 && now >= nextScaling)) {
+        scaleThreads(mem);
+        nextScaling = now + opt_statsInterval;
+      }
+      memoryZone = zone;
+    }
   }
   (void)pthread_mutex_unlock(&m);
+
+  for (i = 0; i < nbsolvers; i++) // Retired threads wake up to see that the job is finished
+      if (solvers[i]->retired)
+	  solvers[i]->resume();
   
   for (i = 0; i < nbsolvers; i++) { // Wait for all threads to finish
       pthread_join(*threads[i], NULL);
   }
   
+  if (verb >= 1 && sharedcomp->winner() != NULL)
+    printf("c All threads stopped %.3f ms after the first answer\n", (realTime() - sharedcomp->jobFinishedTime) * 1000);
+
   assert(sharedcomp != NULL);
   result = sharedcomp->jobStatus;
   if (result == l_True) {
@@ -531,6 +962,8 @@ lbool MultiSolvers::solve() {
 	for(int i = 0; i < n; i++)
 	    model[i] = sharedcomp->jobFinishedBy->model[i];
   }
+  if (ring != NULL)
+      endProcesses();
 
 	
   return result;
@@ -50,7 +50,12 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef MultiSolvers_h
 #define MultiSolvers_h
 
+#include <memory>
+#include <signal.h>
+#include <string>
+
 #include "parallel/ParallelSolver.h"
+#include "parallel/SharedRing.h"
 
 namespace Glucose {
     class SolverConfiguration;
@@ -83,6 +88,15 @@ public:
   ParallelSolver *getPrimarySolver();
   
   void generateAllSolvers();
+
+  // Symmetry: every thread using ESBP builds its own symmetry controller from these files, and
+  // detects interchangeable rows within rows_time_limit seconds if it is not negative
+  void setSymmetrySource(const std::string& cnf_file, const std::string& sym_file, cosy::SymmetryReader reader,
+                         double rows_time_limit = -1);
+  bool attachSymmetryController(int i);
+
+  // Live metrics: each thread publishes its counters in its own slot of this file (see utils/Metrics.h)
+  void setMetricsFile(const std::string& path) { metricsPath = path; }
   
   // Solving:
   //
@@ -90,7 +104,10 @@ public:
   bool eliminate();             // Perform variable elimination
   void adjustParameters();
   void adjustNumberOfCores();
+  void adjustNumberOfProcesses();
+  void scaleThreads(double mem); // Retires a thread when memory is short, resumes one when it is available again
   void interrupt() {}
+  void requestStats() { statsRequested = 1; } // Async-signal safe: stats are printed at the next memory sample
   vec<lbool> model;             // If problem is satisfiable, this vector contains the model (if any).
   inline bool okay() {
     if(!ok) return ok;
@@ -153,12 +170,35 @@ struct Stats {
    //ClauseAllocator     ca;
    SharedCompanion * sharedcomp;
 
-    void informEnd(lbool res);
+    bool hasSymmetrySource;
+    std::string symCNFFile, symFile;
+    cosy::SymmetryReader symReader;
+    double symRowsTimeLimit;
+    std::unique_ptr<cosy::LiteralAdapter<Lit>> symAdapter; // Shared by all the controllers (stateless)
+
+    std::string metricsPath;
+    MetricsFile metricsFile;
+
+    // Processes (see -procs): this one is the process procIndex, its thread i is the thread
+    // firstThread + i over all of them
+    int nbprocs;
+    int procIndex;
+    int firstThread;
+    SharedRing *ring;   // NULL with a single process
+    vec<pid_t> children; // The other processes (in process 0 only)
+    void startProcesses();
+    void endProcesses();
+
+    vec<vec<int> > numaNodes; // Cpus of each NUMA node
+    int  nodeOfThread(int i); // NUMA node of the solver thread i
+    int  cpuOfThread(int i);  // Cpu of the solver thread i, spread over the NUMA nodes (-1 if unknown)
+    void bindThreads(); // Pins the solver threads to cpus, spread over the NUMA nodes (see -numa-bind)
     ParallelSolver* retrieveSolver(int i);
 
     pthread_mutex_t m; // mutex for any high level sync between all threads (like reportf)
     pthread_mutex_t mfinished; // mutex on which main process may wait for... As soon as one process finishes it release the mutex
     pthread_cond_t cfinished; // condition variable that says that a thread has finished
+    volatile sig_atomic_t statsRequested;
 	
     vec<ParallelSolver*> solvers; // set of plain solvers
     vec<SolverCompanion*> solvercompanions; // set of companion solvers
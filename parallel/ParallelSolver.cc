@@ -58,6 +58,13 @@ const char* _parallel = "PARALLEL";
 extern BoolOption opt_dontExportDirectReusedClauses; // (_cunstable, "reusedClauses",    "Don't export directly reused clauses", false);
 extern BoolOption opt_plingeling; // (_cunstable, "plingeling",    "plingeling strategy for sharing clauses (exploratory feature)", false);
 
+static BoolOption opt_symSwitch (_parallel, "sym-switch", "Switch the symmetry mode of a thread when it is useless", true);
+static IntOption opt_symSwitchConflicts (_parallel, "sym-switch-confl", "Number of conflicts between two checks of the symmetry mode yield", 10000, IntRange(1, INT32_MAX));
+static DoubleOption opt_symMinYield (_parallel, "sym-min-yield", "Symmetric inferences by conflict below which a symmetry mode is useless", 0.01, DoubleRange(0, true, HUGE_VAL, false));
+static IntOption opt_importFilter (_parallel, "import-filter", "Log2 of the number of clause signatures kept by each thread to drop duplicated imports (0: no filter)", 16, IntRange(0, 24));
+static IntOption opt_importEvery (_parallel, "import-every", "Number of conflicts between two imports of shared clauses during the search (0: only at level 0, after restarts)", 100, IntRange(0, INT32_MAX));
+static BoolOption opt_shareUnitOrbits (_parallel, "share-unit-orbits", "Share the images of the units under the symmetry generators with the units", true);
+
 
 ParallelSolver::ParallelSolver(int threadId) :
   SimpSolver()
@@ -76,14 +83,32 @@ ParallelSolver::ParallelSolver(int threadId) :
 , limitSharingByFixedLimitSize(0) // No fixed boud (like 40 in plingeling) 
 , dontExportDirectReusedClauses(opt_dontExportDirectReusedClauses)
 , nbNotExportedBecauseDirectlyReused(0)
+, symSwitch(opt_symSwitch)
+, symSwitchConflicts(opt_symSwitchConflicts)
+, symMinYield(opt_symMinYield)
+, symLastConflicts(0), symLastInferences(0)
+, nbSymSwitches(0)
+, importEvery(opt_importEvery)
+, nbImportedInSearch(0), nbImportedAssigning(0), nbImportBacktracks(0)
+, nbImportDuplicates(0), nbImportSubsumed(0)
+, shareUnitOrbits(opt_shareUnitOrbits)
+, nbExportedImages(0), nbImportedImages(0)
+, retired(false)
+, nbRetirements(0)
 {
     useUnaryWatched = true; // We want to use promoted clauses here !
+    pthread_mutex_init(&retireMutex, NULL);
+    pthread_cond_init(&retireCond, NULL);
+    if (opt_importFilter > 0)
+        clauseFilter.growTo(1 << opt_importFilter, 0);
 }
 
 
 
 
 ParallelSolver::~ParallelSolver() {
+    pthread_mutex_destroy(&retireMutex);
+    pthread_cond_destroy(&retireCond);
     printf("c Solver of thread %d ended.\n", thn);
     fflush(stdout);
 }
@@ -104,8 +129,23 @@ ParallelSolver::ParallelSolver(const ParallelSolver &s) : SimpSolver(s)
 , limitSharingByFixedLimitSize(s.limitSharingByFixedLimitSize) // No fixed boud (like 40 in plingeling) 
 , dontExportDirectReusedClauses(s.dontExportDirectReusedClauses)
 , nbNotExportedBecauseDirectlyReused(s.nbNotExportedBecauseDirectlyReused) 
+, symSwitch(s.symSwitch)
+, symSwitchConflicts(s.symSwitchConflicts)
+, symMinYield(s.symMinYield)
+, symLastConflicts(s.symLastConflicts), symLastInferences(s.symLastInferences)
+, nbSymSwitches(s.nbSymSwitches)
+, importEvery(s.importEvery)
+, nbImportedInSearch(s.nbImportedInSearch), nbImportedAssigning(s.nbImportedAssigning), nbImportBacktracks(s.nbImportBacktracks)
+, nbImportDuplicates(s.nbImportDuplicates), nbImportSubsumed(s.nbImportSubsumed)
+, shareUnitOrbits(s.shareUnitOrbits)
+, nbExportedImages(s.nbExportedImages), nbImportedImages(s.nbImportedImages)
+, retired(false)
+, nbRetirements(s.nbRetirements)
 {
+    pthread_mutex_init(&retireMutex, NULL);
+    pthread_cond_init(&retireCond, NULL);
     s.goodImportsFromThreads.memCopyTo(goodImportsFromThreads);   
+    s.clauseFilter.memCopyTo(clauseFilter);
     useUnaryWatched = s.useUnaryWatched;
 }
 
@@ -276,6 +316,9 @@ void ParallelSolver::reportProgressArrayImports(vec<unsigned int> &totalColumns)
 |________________________________________________________________________________________________@*/
 
 bool ParallelSolver::shareClause(Clause & c) {
+    // Clauses deduced from ESBP only hold under the symmetry breaking order of this thread
+    if (c.symmetry())
+        return false;
     bool sent = sharedcomp->addLearnt(this, c);
     if (sent)
         nbexported++;
@@ -294,21 +337,65 @@ bool ParallelSolver::panicModeIsEnabled() {
     return sharedcomp->panicMode;
 }
 
+/*_________________________________________________________________________________________________
+|
+|  subsumedByUnitOrBinary : (vec<Lit>& c)   ->  [bool]
+|  
+|  Description:
+|  true if c has a literal true at level 0, or both literals of a binary clause of this thread
+|________________________________________________________________________________________________@*/
+
+bool ParallelSolver::subsumedByUnitOrBinary(const vec<Lit>& c) {
+    for (int i = 0; i < c.size(); i++)
+        if (value(c[i]) == l_True && level(var(c[i])) == 0)
+            return true;
+    for (int i = 0; i < c.size(); i++)
+        seen[var(c[i])] = 1 + sign(c[i]); // Must be cleared before returning (conflict analysis)
+
+    bool subsumed = false;
+    for (int i = 0; i < c.size() && !subsumed; i++) {
+        const vec<Watcher>& wbin = watchesBin[~c[i]]; // Binary clauses (c[i] blocker)
+        for (int k = 0; k < wbin.size(); k++) {
+            Lit other = wbin[k].blocker;
+            if (seen[var(other)] == 1 + sign(other) && !ca[wbin[k].cref].mark()) {
+                subsumed = true;
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < c.size(); i++)
+        seen[var(c[i])] = 0;
+    return subsumed;
+}
+
 /*_________________________________________________________________________________________________
 |
 |  parallelImportUnaryClauses : ()   ->  [void]
 |  
 |  Description:
-|  import all unary clauses from other cores
+|  import all unary clauses from other cores. The images of a unit come with it: its orbit is
+|  known to be shared.
 |________________________________________________________________________________________________@*/
 
 void ParallelSolver::parallelImportUnaryClauses() {
     Lit l;
-    while ((l = sharedcomp->getUnary(this)) != lit_Undef) {
-        if (value(var(l)) == l_Undef) {
-            uncheckedEnqueue(l);
-            nbimportedunit++;
+    bool image, closed;
+    orbitShared.growTo(nVars(), 0);
+    while ((l = sharedcomp->getUnary(this, image, closed)) != lit_Undef) {
+        if (closed)
+            orbitShared[var(l)] = 1;
+        if (value(var(l)) != l_Undef && level(var(l)) == 0)
+            continue;
+        if (image)
+            nbImportedImages++;
+        if (decisionLevel() > 0) { // Imported during the search: a unit belongs to level 0
+            nbImportedInSearch++;
+            nbImportBacktracks++;
+            cancelUntil(0);
         }
+        uncheckedEnqueue(l);
+        nbimportedunit++;
     }
 }
 
@@ -317,14 +404,15 @@ void ParallelSolver::parallelImportUnaryClauses() {
 |  parallelImportClauses : ()   ->  [bool]
 |  
 |  Description:
-|  import all clauses from other cores
+|  import all clauses from other cores, at any decision level. A clause that is unit or
+|  conflicting under the current trail makes the search backjump to the level where it propagates.
 |  Output : if there is a final conflict
 |________________________________________________________________________________________________@*/
 
 bool ParallelSolver::parallelImportClauses() {
 
-    assert(decisionLevel() == 0);
     int importedFromThread;
+    nextImportConflicts = importEvery > 0 ? conflicts + importEvery : UINT64_MAX;
     while (sharedcomp->getNewClause(this, importedFromThread, importedClause)) {
         assert(importedFromThread <= sharedcomp->nbThreads);
         assert(importedFromThread >= 0);
@@ -333,6 +421,46 @@ bool ParallelSolver::parallelImportClauses() {
 
         if (importedClause.size() == 0)
             return true;
+        assert(importedClause.size() > 1);
+
+        uint64_t signature = clauseSignature(importedClause);
+        if (isKnownClause(signature)) {
+            nbImportDuplicates++;
+            continue;
+        }
+        rememberClause(signature);
+        if (subsumedByUnitOrBinary(importedClause)) {
+            nbImportSubsumed++;
+            continue;
+        }
+        if (decisionLevel() > 0)
+            nbImportedInSearch++;
+
+        // Watch the literals that are not false, then the false ones of highest levels
+        for (int w = 0; w < 2; w++) {
+            int best = w;
+            for (int i = w + 1; i < importedClause.size(); i++)
+                if (value(importedClause[best]) == l_False &&
+                    (value(importedClause[i]) != l_False || level(var(importedClause[i])) > level(var(importedClause[best]))))
+                    best = i;
+            Lit tmp = importedClause[w]; importedClause[w] = importedClause[best]; importedClause[best] = tmp;
+        }
+
+        // Unit or conflicting: go back to the highest level where it is unit, or before the
+        // level of its two last literals if they were falsified together
+        bool assigning = value(importedClause[1]) == l_False && value(importedClause[0]) != l_True;
+        if (assigning) {
+            int lvl = level(var(importedClause[1]));
+            if (value(importedClause[0]) == l_False && level(var(importedClause[0])) == lvl)
+                lvl--;
+            if (lvl < 0)
+                return true; // Falsified at level 0
+            if (lvl < decisionLevel()) {
+                nbImportBacktracks++;
+                cancelUntil(lvl);
+            }
+            nbImportedAssigning++;
+        }
 
         //printf("Thread %d imports clause from thread %d\n", threadNumber(), importedFromThread);
         CRef cr = ca.alloc(importedClause, true, true);
@@ -344,7 +472,7 @@ bool ParallelSolver::parallelImportClauses() {
         }
         ca[cr].setImportedFrom(importedFromThread);
         unaryWatchedClauses.push(cr);
-        if (plingeling || ca[cr].size() <= 2) {//|| importedRoute == 0) { // importedRoute == 0 means a glue clause in another thread (or any very good clause)
+        if (plingeling || assigning || ca[cr].size() <= 2) {//|| importedRoute == 0) { // importedRoute == 0 means a glue clause in another thread (or any very good clause)
             ca[cr].setOneWatched(false); // Warning: those clauses will never be promoted by a conflict clause (or rarely: they are propagated!)
             attachClause(cr);
             nbImportedGoodClauses++;
@@ -355,6 +483,8 @@ bool ParallelSolver::parallelImportClauses() {
         }
         assert(ca[cr].learnt());
         nbimported++;
+        if (assigning && value(ca[cr][0]) == l_Undef && value(ca[cr][1]) == l_False)
+            uncheckedEnqueue(ca[cr][0], cr);
     }
     return false;
 }
@@ -365,13 +495,38 @@ bool ParallelSolver::parallelImportClauses() {
 |  parallelExportUnaryClause : (Lit p)   ->  [void]
 |  
 |  Description:
-|  export unary clauses to other cores
+|  export unary clauses to other cores. With symmetries, the images of p under the group (its orbit,
+|  closed over the generators) are units too, and they are exported with it: the other threads
+|  receive them at once, instead of deriving each of them through SEL. The orbit of a unit that
+|  was already shared, or received, is not walked again.
 |________________________________________________________________________________________________@*/
 
 void ParallelSolver::parallelExportUnaryClause(Lit p) {
-    // Multithread
-    sharedcomp->addLearnt(this,p ); // TODO: there can be a contradiction here (two theads proving a and -a)
+    if (isESBPUnit(var(p)))
+        return; // Deduced from ESBP
     nbexportedunit++;
+    if (!shareUnitOrbits || nGenerators() == 0) {
+        sharedcomp->addLearnt(this,p ); // TODO: there can be a contradiction here (two theads proving a and -a)
+        return;
+    }
+
+    orbitShared.growTo(nVars(), 0);
+    if (orbitShared[var(p)]) { // p is an image of a shared unit
+        sharedcomp->addLearnt(this, p);
+        return;
+    }
+    orbit.clear();
+    orbit.push(p);
+    orbitShared[var(p)] = 1;
+    for (int i = 0; i < orbit.size(); i++)
+        for (int g = 0; g < nGenerators(); g++) {
+            Lit image = generator(g)->getImage(orbit[i]);
+            if (!orbitShared[var(image)]) {
+                orbitShared[var(image)] = 1;
+                orbit.push(image);
+            }
+        }
+    nbExportedImages += sharedcomp->addLearnts(this, orbit);
 }
 
 
@@ -386,6 +541,8 @@ void ParallelSolver::parallelExportUnaryClause(Lit p) {
 |________________________________________________________________________________________________@*/
 
 void ParallelSolver::parallelExportClauseDuringSearch(Clause &c) {
+    rememberClause(clauseSignature(c)); // Its copies sent back by the other threads are dropped
+
     //
     // Multithread
     // Now I'm sharing the clause if seen in at least two conflicts analysis shareClause(ca[cr]);
@@ -434,6 +591,8 @@ lbool ParallelSolver::solve_(bool do_simp, bool turn_off_simp) {
         result = lbool(eliminate(turn_off_simp));
     }
 
+    initSymmetry();
+
     model.clear();
     conflict.clear();
     if (!ok) return l_False;
@@ -447,9 +606,17 @@ lbool ParallelSolver::solve_(bool do_simp, bool turn_off_simp) {
     int curr_restarts = 0;
     while (status == l_Undef && !sharedcomp->jobFinished()) {
         status = search(0); // the parameter is useless in glucose, kept to allow modifications
+        if (metrics != NULL && status == l_Undef)
+            publishMetrics(SolverMetrics::Running);
+        if (status == l_Undef && retired)
+            retire();
         if (!withinBudget()) break;
         curr_restarts++;
+        if (status == l_Undef)
+            adaptSymmetryMode();
     }
+    if (metrics != NULL)
+        publishMetrics(status == l_True ? SolverMetrics::Satisfiable : status == l_False ? SolverMetrics::Unsatisfiable : SolverMetrics::Stopped);
 
     if (verbosity >= 1)
         printf("c =========================================================================================================\n");
@@ -470,17 +637,19 @@ lbool ParallelSolver::solve_(bool do_simp, bool turn_off_simp) {
     }
     
     if (firstToFinish && status == l_True) {
-        extendModel();
-
-
-        // Extend & copy model:
+        // Copy & extend model (eliminated variables are set by extendModel):
         model.growTo(nVars());
         for (int i = 0; i < nVars(); i++) model[i] = value(i);
+        extendModel();
     } else if (status == l_False && conflict.size() == 0)
         ok = false;
 
 
+    // Wakes up the coordinator (MultiSolvers::solve), which checks the ended threads under pmfinished
+    sharedcomp->threadEnded();
+    pthread_mutex_lock(pmfinished);
     pthread_cond_signal(pcfinished);
+    pthread_mutex_unlock(pmfinished);
 
     //cancelUntil(0);
 
@@ -488,3 +657,130 @@ lbool ParallelSolver::solve_(bool do_simp, bool turn_off_simp) {
     return status;
 
 }
+
+
+
+/*_________________________________________________________________________________________________
+|
+|  retire : ()   ->  [void]
+|  
+|  Description:
+|  sleeps at level 0, with only the glue and binary learnt clauses, until MultiSolvers calls resume
+|  (or the job is finished). The clauses shared meanwhile are not read.
+|________________________________________________________________________________________________@*/
+
+void ParallelSolver::requestRetirement() {
+    pthread_mutex_lock(&retireMutex);
+    retired = true;
+    pthread_mutex_unlock(&retireMutex);
+}
+
+void ParallelSolver::resume() {
+    pthread_mutex_lock(&retireMutex);
+    retired = false;
+    pthread_cond_signal(&retireCond);
+    pthread_mutex_unlock(&retireMutex);
+}
+
+void ParallelSolver::retire() {
+    nbRetirements++;
+    cancelUntil(0);
+    releaseLearnts();
+    sharedcomp->pauseSharing(this);
+    if (metrics != NULL)
+        publishMetrics(SolverMetrics::Stopped);
+
+    pthread_mutex_lock(&retireMutex);
+    while (retired && !sharedcomp->jobFinished())
+        pthread_cond_wait(&retireCond, &retireMutex);
+    pthread_mutex_unlock(&retireMutex);
+
+    sharedcomp->resumeSharing(this);
+}
+
+void ParallelSolver::releaseLearnts() {
+    int i, j;
+    for (i = j = 0; i < learnts.size(); i++) {
+        Clause& c = ca[learnts[i]];
+        if (c.lbd() > 2 && c.size() > 2 && !locked(c))
+            removeClause(learnts[i]);
+        else
+            learnts[j++] = learnts[i];
+    }
+    learnts.shrink(i - j);
+
+    for (i = j = 0; i < unaryWatchedClauses.size(); i++) {
+        Clause& c = ca[unaryWatchedClauses[i]];
+        if (c.lbd() > 2 && c.size() > 2 && !locked(c))
+            removeClause(unaryWatchedClauses[i], c.getOneWatched());
+        else
+            unaryWatchedClauses[j++] = unaryWatchedClauses[i];
+    }
+    unaryWatchedClauses.shrink(i - j);
+
+    garbageCollect();
+}
+
+int ParallelSolver::symmetryMode() const {
+    int mode = SYM_NONE;
+    if (useSEL && nGenerators() > 0) mode |= SYM_SEL;
+    if (symmetry != nullptr) mode |= SYM_ESBP;
+    return mode;
+}
+
+uint64_t ParallelSolver::symmetryInferences() const {
+    return symgenprops + symgenconfls + symselprops + symselconfls + symesbpconfls;
+}
+
+bool ParallelSolver::symmetryModeReachable(int mode) const {
+    if ((mode & SYM_SEL) && nGenerators() == 0) return false;
+    if ((mode & SYM_ESBP) && symmetry == nullptr) return false;
+    return true;
+}
+
+void ParallelSolver::setSymmetryMode(int mode) {
+    cancelUntil(0);
+    setSEL(mode & SYM_SEL);
+    if (!(mode & SYM_ESBP))
+        symmetry.reset(); // ESBP clauses already learnt remain sound
+    nbSymSwitches++;
+}
+
+/*_________________________________________________________________________________________________
+|
+|  adaptSymmetryMode : ()   ->  [void]
+|  
+|  Description:
+|  Called between two restarts. Every symSwitchConflicts conflicts, reports the symmetric
+|  inferences of the thread to the shared companion. If the current mode is useless, switches
+|  to the reachable mode with the best yield over all threads (or to no symmetry at all).
+|  ESBP can only be dropped: clauses learnt under an order are not compatible with another one.
+|________________________________________________________________________________________________@*/
+
+void ParallelSolver::adaptSymmetryMode() {
+    if (!symSwitch || conflicts - symLastConflicts < symSwitchConflicts)
+        return;
+
+    int mode = symmetryMode();
+    uint64_t dc = conflicts - symLastConflicts;
+    uint64_t di = symmetryInferences() - symLastInferences;
+    symLastConflicts = conflicts;
+    symLastInferences = symmetryInferences();
+    sharedcomp->addSymmetryYield(mode, dc, di);
+
+    if (mode == SYM_NONE || (double)di / (double)dc >= symMinYield)
+        return;
+
+    int best = SYM_NONE;
+    double bestYield = symMinYield;
+    for (int m = 0; m < NB_SYM_MODES; m++) {
+        if (m == mode || m == SYM_NONE || !symmetryModeReachable(m))
+            continue;
+        double y = sharedcomp->symmetryYield(m);
+        if (y >= bestYield) {
+            best = m;
+            bestYield = y;
+        }
+    }
+    setSymmetryMode(best);
+}
@@ -122,6 +122,56 @@ public:
     
     vec<uint32_t> goodImportsFromThreads; // Stats of good importations from other threads
 
+    // Symmetry mode of this thread (see SolverConfiguration). A useless mode is switched
+    // at a restart for the best mode reachable from it, given the yield over all threads.
+    bool symSwitch;
+    uint64_t symSwitchConflicts;  // Number of conflicts between two checks of the yield
+    double symMinYield;           // Symmetric inferences by conflict for a mode to be useful
+    uint64_t symLastConflicts, symLastInferences; // Counters at the last check
+    uint64_t nbSymSwitches;
+
+    int symmetryMode() const;
+    uint64_t symmetryInferences() const;
+    bool symmetryModeReachable(int mode) const;
+    void setSymmetryMode(int mode);
+    void adaptSymmetryMode();
+
+    uint64_t importEvery;         // Conflicts between two imports during the search (0: at level 0 only)
+    uint64_t nbImportedInSearch;  // Clauses and units imported at a non-zero level
+    uint64_t nbImportedAssigning; // Imported clauses that were unit or conflicting under the trail
+    uint64_t nbImportBacktracks;  // Backjumps made to use an imported clause or unit
+
+    // Signatures of the clauses recently learnt or imported by this thread, direct mapped (see
+    // -import-filter): an imported clause that is already known is dropped before its allocation
+    vec<uint64_t> clauseFilter;
+    uint64_t nbImportDuplicates;  // Imported clauses dropped as already known
+    uint64_t nbImportSubsumed;    // Imported clauses dropped as subsumed by a unit or a binary clause
+
+    // A unit is exported with its images under the generators (its orbit), so that the other threads
+    // get them without deriving them again through SEL (see parallelExportUnaryClause)
+    bool shareUnitOrbits;
+    vec<char> orbitShared;        // Indexed by variable: the orbit of its unit was shared (or received)
+    vec<Lit> orbit;
+    uint64_t nbExportedImages;    // Images of units added to the shared units by this thread
+    uint64_t nbImportedImages;    // Images of units received by this thread, that it did not know yet
+
+    template<class C> static uint64_t clauseSignature(const C& c);
+    bool isKnownClause(uint64_t signature) const;
+    void rememberClause(uint64_t signature);
+    bool subsumedByUnitOrBinary(const vec<Lit>& c);
+
+    // Retirement, asked by MultiSolvers when memory is short: at its next restart, the thread sheds
+    // its learnt clauses, leaves the clause sharing and sleeps until it is resumed or the job ends
+    volatile bool retired;
+    pthread_mutex_t retireMutex;
+    pthread_cond_t retireCond;
+    uint64_t nbRetirements;
+
+    void requestRetirement();
+    void resume();
+    void retire();
+    void releaseLearnts();
+
     virtual void parallelImportClauseDuringConflictAnalysis(Clause &c,CRef confl);
     virtual bool parallelImportClauses(); // true if the empty clause was received
     virtual void parallelImportUnaryClauses();
@@ -139,6 +189,24 @@ public:
 
     inline int      ParallelSolver::threadNumber  ()      const   {return thn;}
     inline void     ParallelSolver::setThreadNumber (int i)       {thn = i;}
+
+    // Order independent (sum of the mixed literals, as in splitmix64); 0 is an empty entry of the filter
+    template<class C>
+    inline uint64_t ParallelSolver::clauseSignature(const C& c) {
+        uint64_t sum = (uint64_t)c.size();
+        for (int i = 0; i < c.size(); i++) {
+            uint64_t x = (uint64_t)toInt(c[i]) + 0x9E3779B97F4A7C15ULL;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            sum += x ^ (x >> 31);
+        }
+        return sum == 0 ? 1 : sum;
+    }
+
+    inline bool     ParallelSolver::isKnownClause(uint64_t signature) const {
+        return clauseFilter.size() > 0 && clauseFilter[signature & (clauseFilter.size() - 1)] == signature; }
+    inline void     ParallelSolver::rememberClause(uint64_t signature) {
+        if (clauseFilter.size() > 0) clauseFilter[signature & (clauseFilter.size() - 1)] = signature; }
 }
 #endif	/* PARALLELSOLVER_H */
 
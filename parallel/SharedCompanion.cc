@@ -52,25 +52,35 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "core/SolverTypes.h"
 #include "parallel/ClausesBuffer.h"
 #include "parallel/SharedCompanion.h"
+#include "utils/System.h"
 
 
 using namespace Glucose;
 
 SharedCompanion::SharedCompanion(int _nbThreads) :
     nbThreads(_nbThreads), 
+    ring(NULL),
+    process(0),
+    firstThread(0),
+    nextRingUnit(0),
     bjobFinished(false),
+    nbEndedThreads(0),
     jobFinishedBy(NULL),
+    jobFinishedTime(0),
     panicMode(false), // The bug in the SAT2014 competition :)
     jobStatus(l_Undef),
-    random_seed(9164825) {
+    random_seed(9164825),
+    sharingStartTime(realTime()) {
 
 	pthread_mutex_init(&mutexSharedClauseCompanion,NULL); // This is the shared companion lock
 	pthread_mutex_init(&mutexSharedUnitCompanion,NULL); // This is the shared companion lock
 	pthread_mutex_init(&mutexSharedCompanion,NULL); // This is the shared companion lock
 	pthread_mutex_init(&mutexJobFinished,NULL); // This is the shared companion lock
+	for (int i = 0; i < NB_SYM_MODES; i++)
+	    symModeConflicts[i] = symModeInferences[i] = 0;
 	if (_nbThreads> 0)  {
 	    setNbThreads(_nbThreads);
-	    fprintf(stdout,"c Shared companion initialized: handling of clauses of %d threads.\nc %d ints for the sharing clause buffer (not expandable) .\n", _nbThreads, clausesBuffer.maxSize());
+	    fprintf(stdout,"c Shared companion initialized: handling of clauses of %d threads.\nc %d ints for the sharing clause buffer (expandable to %d).\n", _nbThreads, clausesBuffer.maxSize(), clausesBuffer.maxCapacity());
 	}
 
 }
@@ -78,9 +88,71 @@ SharedCompanion::SharedCompanion(int _nbThreads) :
 void SharedCompanion::setNbThreads(int _nbThreads) {
    nbThreads = _nbThreads;
    clausesBuffer.setNbThreads(_nbThreads); 
+   sharingStartTime = realTime();
 }
 
+void SharedCompanion::setRing(SharedRing *r, int _process) {
+   ring = r;
+   process = _process;
+   firstThread = _process * nbThreads;
+}
+
+// Sharing bandwidth through the blackboard (one word = one uint32_t of the fifo)
 void SharedCompanion::printStats() {
+    pthread_mutex_lock(&mutexSharedClauseCompanion);
+    uint64_t pushedClauses = clausesBuffer.nbPushedClauses(), pushedWords = clausesBuffer.nbPushedWords();
+    uint64_t readClauses = clausesBuffer.nbReadClauses(), readWords = clausesBuffer.nbReadWords();
+    unsigned int removed = clausesBuffer.nbRemovedClauses(), forced = clausesBuffer.nbForcedRemovedClauses();
+    unsigned int evicted = clausesBuffer.nbEvictedClauses(), rejected = clausesBuffer.nbRejectedClauses();
+    unsigned int growths = clausesBuffer.nbGrowths();
+    int size = clausesBuffer.maxSize();
+    vec<uint64_t> produced, consumed, dropped;
+    vec<unsigned int> lags;
+    for (int i = 0; i < nbThreads; i++) {
+	produced.push(clausesBuffer.nbProduced(i));
+	lags.push(clausesBuffer.maxLagOf(i));
+	for (int j = 0; j < nbThreads; j++) {
+	    consumed.push(clausesBuffer.nbConsumed(i, j));
+	    dropped.push(clausesBuffer.nbDroppedUnread(i, j));
+	}
+    }
+    pthread_mutex_unlock(&mutexSharedClauseCompanion);
+    pthread_mutex_lock(&mutexSharedUnitCompanion);
+    int units = unitLit.size();
+    pthread_mutex_unlock(&mutexSharedUnitCompanion);
+
+    double elapsed = realTime() - sharingStartTime;
+    if (elapsed <= 0) elapsed = 1e-6;
+    double mbPushed = (double)pushedWords * sizeof(uint32_t) / (1024 * 1024);
+    double mbRead = (double)readWords * sizeof(uint32_t) / (1024 * 1024);
+    printf("c\n");
+    printf("c Sharing: %d units, %" PRIu64" clauses pushed (%.2f Mb), %" PRIu64" clauses read (%.2f Mb)\n",
+	   units, pushedClauses, mbPushed, readClauses, mbRead);
+    printf("c Sharing: %u clauses removed from the fifo (%u before being read by all threads, %u for better ones), %u rejected\n",
+	   removed, forced + evicted, evicted, rejected);
+    printf("c Sharing: fifo of %d ints (%u growths)\n", size, growths);
+    printf("c Sharing by thread: produced, then read / dropped before being read by each thread, max lag (ints)\n");
+    for (int i = 0; i < nbThreads; i++) {
+	printf("c  %3d: %9" PRIu64" |", i, produced[i]);
+	for (int j = 0; j < nbThreads; j++)
+	    if (i == j) printf("         -        ");
+	    else printf(" %9" PRIu64"/%-7" PRIu64, consumed[i * nbThreads + j], dropped[i * nbThreads + j]);
+	printf(" | %9u\n", lags[i]);
+    }
+    printf("c Sharing bandwidth: %.3f Mb/s written, %.3f Mb/s read\n", mbPushed / elapsed, mbRead / elapsed);
+
+    if (ring != NULL) { // Totals of all the processes
+	SharedRing::Stats rs;
+	ring->stats(rs);
+	double mbRingPushed = (double)rs.pushedWords * sizeof(uint32_t) / (1024 * 1024);
+	double mbRingRead = (double)rs.readWords * sizeof(uint32_t) / (1024 * 1024);
+	if (rs.elapsed <= 0) rs.elapsed = 1e-6;
+	printf("c Sharing between processes: %d units, %" PRIu64" clauses pushed (%.2f Mb), %" PRIu64" clauses read (%.2f Mb)\n",
+	       rs.units, rs.pushedClauses, mbRingPushed, rs.readClauses, mbRingRead);
+	printf("c Sharing between processes: %" PRIu64" clauses removed from the fifo of %" PRIu64" ints (%" PRIu64" before being read by all threads, %" PRIu64" for better ones, %" PRIu64" unread copies), %" PRIu64" rejected\n",
+	       rs.removed, rs.capacity, rs.forced + rs.evicted, rs.evicted, rs.droppedUnread, rs.rejected);
+	printf("c Sharing bandwidth between processes: %.3f Mb/s written, %.3f Mb/s read\n", mbRingPushed / rs.elapsed, mbRingRead / rs.elapsed);
+    }
 }
 
 // No multithread safe
@@ -97,22 +169,65 @@ void SharedCompanion::newVar(bool sign) {
    isUnary .push(l_Undef);
 }
 
+enum { UnitPlain = 0, UnitOrbit = 1, UnitImage = 2 };
+
 void SharedCompanion::addLearnt(ParallelSolver *s,Lit unary) {
+  bool added = false;
   pthread_mutex_lock(&mutexSharedUnitCompanion);
   if (isUnary[var(unary)]==l_Undef) {
       unitLit.push(unary);
+      unitKind.push(UnitPlain);
+      unitFrom.push(s->thn);
       isUnary[var(unary)] = sign(unary)?l_False:l_True;
+      added = true;
   } 
   pthread_mutex_unlock(&mutexSharedUnitCompanion);
+  if (added && ring != NULL)
+      ring->addUnit(unary);
 }
 
-Lit SharedCompanion::getUnary(ParallelSolver *s) {
+// orbit[0] is the unit, followed by its images: they are pushed together, so that a reader never
+// sees a part of the orbit only
+// The other processes get them as plain units
+int SharedCompanion::addLearnts(ParallelSolver *s, const vec<Lit>& orbit) {
+  int images = 0, first;
+  pthread_mutex_lock(&mutexSharedUnitCompanion);
+  first = unitLit.size();
+  for (int i = 0; i < orbit.size(); i++)
+      if (isUnary[var(orbit[i])]==l_Undef) {
+	  unitLit.push(orbit[i]);
+	  unitKind.push(i == 0 ? UnitOrbit : UnitImage);
+	  unitFrom.push(s->thn);
+	  isUnary[var(orbit[i])] = sign(orbit[i])?l_False:l_True;
+	  if (i > 0) images++;
+      }
+  if (ring != NULL)
+      for (int i = first; i < unitLit.size(); i++)
+	  ring->addUnit(unitLit[i]);
+  pthread_mutex_unlock(&mutexSharedUnitCompanion);
+  return images;
+}
+
+Lit SharedCompanion::getUnary(ParallelSolver *s, bool& image, bool& closed) {
   int sn = s->thn;
   Lit ret = lit_Undef;
 
   pthread_mutex_lock(&mutexSharedUnitCompanion);
-  if (nextUnit[sn] < unitLit.size())
+  if (ring != NULL)
+      for (int n = ring->nbUnits(); nextRingUnit < n; nextRingUnit++) {
+	  Lit p = ring->unit(nextRingUnit);
+	  if (isUnary[var(p)]==l_Undef) { // Units of this process come back, already known
+	      unitLit.push(p);
+	      unitKind.push(UnitPlain);
+	      unitFrom.push(-1);
+	      isUnary[var(p)] = sign(p)?l_False:l_True;
+	  }
+      }
+  if (nextUnit[sn] < unitLit.size()) {
+      image = unitKind[nextUnit[sn]] == UnitImage && unitFrom[nextUnit[sn]] != sn;
+      closed = unitKind[nextUnit[sn]] != UnitPlain;
       ret = unitLit[nextUnit[sn]++];
+  }
   pthread_mutex_unlock(&mutexSharedUnitCompanion);
  return ret;
 }
@@ -128,6 +243,8 @@ bool SharedCompanion::addLearnt(ParallelSolver *s, Clause & c) {
   pthread_mutex_lock(&mutexSharedClauseCompanion);
   ret = clausesBuffer.pushClause(sn, c);
   pthread_mutex_unlock(&mutexSharedClauseCompanion);
+  if (ring != NULL && ring->pushClause(firstThread + sn, c))
+      ret = true;
   return ret;
 }
 
@@ -139,25 +256,58 @@ bool SharedCompanion::getNewClause(ParallelSolver *s, int & threadOrigin, vec<Li
     pthread_mutex_lock(&mutexSharedClauseCompanion);
     bool b = clausesBuffer.getClause(sn, threadOrigin, newclause);
     pthread_mutex_unlock(&mutexSharedClauseCompanion);
+
+    // Then the clauses of the other processes, all coming from the pseudo thread nbThreads
+    if (!b && ring != NULL && ring->getClause(firstThread + sn, newclause)) {
+	threadOrigin = nbThreads;
+	b = true;
+    }
  
   return b;
 }
 
-bool SharedCompanion::jobFinished() {
-    bool ret = false;
-    pthread_mutex_lock(&mutexJobFinished);
-    ret = bjobFinished;
-    pthread_mutex_unlock(&mutexJobFinished);
+void SharedCompanion::pauseSharing(ParallelSolver *s) {
+    pthread_mutex_lock(&mutexSharedClauseCompanion);
+    clausesBuffer.pauseReader(s->thn);
+    pthread_mutex_unlock(&mutexSharedClauseCompanion);
+    if (ring != NULL)
+	ring->pauseReader(firstThread + s->thn);
+}
+
+void SharedCompanion::resumeSharing(ParallelSolver *s) {
+    pthread_mutex_lock(&mutexSharedClauseCompanion);
+    clausesBuffer.resumeReader(s->thn);
+    pthread_mutex_unlock(&mutexSharedClauseCompanion);
+    if (ring != NULL)
+	ring->resumeReader(firstThread + s->thn);
+}
+
+void SharedCompanion::addSymmetryYield(int mode, uint64_t conflicts, uint64_t inferences) {
+    pthread_mutex_lock(&mutexSharedCompanion);
+    symModeConflicts[mode] += conflicts;
+    symModeInferences[mode] += inferences;
+    pthread_mutex_unlock(&mutexSharedCompanion);
+}
+
+double SharedCompanion::symmetryYield(int mode) {
+    double ret = 0;
+    pthread_mutex_lock(&mutexSharedCompanion);
+    if (symModeConflicts[mode] > 0)
+	ret = (double)symModeInferences[mode] / (double)symModeConflicts[mode];
+    pthread_mutex_unlock(&mutexSharedCompanion);
     return ret;
 }
 
 bool SharedCompanion::IFinished(ParallelSolver *s) {
     bool ret = false;
     pthread_mutex_lock(&mutexJobFinished);
-    if (!bjobFinished) {
-	ret = true;
-	bjobFinished = true;
-	jobFinishedBy = s;
+    if (!bjobFinished.load(std::memory_order_relaxed)) {
+	ret = ring == NULL || ring->claim(process, firstThread + s->thn); // Else another process answered first
+	if (ret) {
+	    jobFinishedBy = s;
+	    jobFinishedTime = realTime();
+	}
+	bjobFinished.store(true, std::memory_order_release);
     }
     pthread_mutex_unlock(&mutexJobFinished);
     return ret;
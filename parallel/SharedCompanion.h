@@ -56,13 +56,17 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #ifndef SharedCompanion_h
 #define SharedCompanion_h
+#include <atomic>
 #include "core/SolverTypes.h"
 #include "parallel/ParallelSolver.h"
 #include "parallel/SolverCompanion.h"
 #include "parallel/ClausesBuffer.h"
+#include "parallel/SharedRing.h"
 
 namespace Glucose {
 
+// Symmetry handling of a thread: a combination of SEL and ESBP (see SolverConfiguration)
+enum SymmetryMode { SYM_NONE = 0, SYM_SEL = 1, SYM_ESBP = 2, SYM_BOTH = 3, NB_SYM_MODES = 4 };
     
 class SharedCompanion : public SolverCompanion {
     friend class MultiSolvers;
@@ -70,23 +74,36 @@ class SharedCompanion : public SolverCompanion {
 public:
 	SharedCompanion(int nbThreads=0);
 	void setNbThreads(int _nbThreads); // Sets the number of threads (cannot by changed once the solver is running)
+	void setRing(SharedRing *r, int process); // Also shares with the other processes (see -procs), once the threads are set
 	void newVar(bool sign);            // Adds a var (used to keep track of unary variables)
 	void printStats();                 // Printing statistics of all solvers
 
-	bool jobFinished();                // True if the job is over
-	bool IFinished(ParallelSolver *s); // returns true if you are the first solver to finish
+	bool jobFinished();                // True if the job is over, here or in another process (lock free: polled at each conflict)
+	bool IFinished(ParallelSolver *s); // returns true if you are the first solver to finish (over all the processes)
+	void threadEnded();                // A solver thread returns
+	int nbThreadsEnded();
 	bool addSolver(ParallelSolver*);   // attach a solver to accompany 
 	void addLearnt(ParallelSolver *s,Lit unary);   // Add a unary clause to share
+	int addLearnts(ParallelSolver *s, const vec<Lit>& orbit); // Add a unary clause and its images, returns the number of images added
 	bool addLearnt(ParallelSolver *s, Clause & c); // Add a clause to the shared companion, as a database manager
 
 	bool getNewClause(ParallelSolver *s, int &th, vec<Lit> & nc); // gets a new interesting clause for solver s 
-	Lit getUnary(ParallelSolver *s);                              // Gets a new unary literal
+	Lit getUnary(ParallelSolver *s, bool& image, bool& closed);   // Gets a new unary literal (an image shared by another thread, or with its orbit)
+	void pauseSharing(ParallelSolver *s);                         // s is retired: no clause waits for it
+	void resumeSharing(ParallelSolver *s);                        // s reads the clauses shared from now on
 	inline ParallelSolver* winner(){return jobFinishedBy;}        // Gets the first solver that called IFinished()
 
+	void addSymmetryYield(int mode, uint64_t conflicts, uint64_t inferences); // Reports the symmetric inferences made in a mode
+	double symmetryYield(int mode);                                           // Symmetric inferences by conflict in a mode, over all threads
+
  protected:
 
 	ClausesBuffer clausesBuffer; // A big blackboard for all threads sharing non unary clauses
 	int nbThreads;               // Number of threads
+	SharedRing *ring;            // Between the processes (NULL with a single one)
+	int process;                 // Index of this process
+	int firstThread;             // Number of thread 0 over all the processes
+	int nextRingUnit;            // Next unit of the ring to import (protected by mutexSharedUnitCompanion)
 	
 	// A set of mutex variables
 	pthread_mutex_t mutexSharedCompanion; // mutex for any high level sync between all threads (like reportf)
@@ -94,8 +111,10 @@ public:
 	pthread_mutex_t mutexSharedUnitCompanion; // mutex for reading/writing unit clauses on the blackboard 
         pthread_mutex_t mutexJobFinished;
 
-	bool bjobFinished;
+	std::atomic<bool> bjobFinished;
+	std::atomic<int> nbEndedThreads;
 	ParallelSolver *jobFinishedBy;
+	double jobFinishedTime;                // Real time of the first answer
 	bool panicMode;                        // panicMode means no more increasing space needed
 	lbool jobStatus;                       // globale status of the job
 
@@ -103,8 +122,15 @@ public:
 	//	friend class wholearnt;
 	vec<int> nextUnit; // indice of next unit clause to retrieve for solver number i 
 	vec<Lit> unitLit;  // Set of unit literals found so far
+	vec<char> unitKind; // For each unit: plain, shared with its orbit, or image (see addLearnts)
+	vec<int> unitFrom;  // For each unit: the thread that shared it (-1 for another process)
         vec<lbool> isUnary; // sign of the unary var (if proved, or l_Undef if not)	
 	double    random_seed;
+	double    sharingStartTime; // Real time at which the threads started to share (for bandwidth)
+
+	// Per symmetry mode statistics, shared by all threads (protected by mutexSharedCompanion)
+	uint64_t symModeConflicts[NB_SYM_MODES];
+	uint64_t symModeInferences[NB_SYM_MODES];
 
 	// Returns a random float 0 <= x < 1. Seed must never be 0.
 	static inline double drand(double& seed) {
@@ -118,5 +144,9 @@ public:
 	    return (int)(drand(seed) * size); }
 
 };
+
+inline bool SharedCompanion::jobFinished() { return bjobFinished.load(std::memory_order_acquire) || (ring != NULL && ring->answered()); }
+inline void SharedCompanion::threadEnded() { nbEndedThreads++; }
+inline int SharedCompanion::nbThreadsEnded() { return nbEndedThreads.load(); }
 }
 #endif
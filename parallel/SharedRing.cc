@@ -0,0 +1,287 @@
+/**************************************************************************************[SharedRing.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "parallel/SharedRing.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <new>
+#include <sys/mman.h>
+
+#include "utils/System.h"
+
+using namespace Glucose;
+
+// The processes see the atomics through different mappings of the same pages
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<int>::is_always_lock_free,
+              "the shared ring needs address-free atomics");
+
+static inline size_t align8(size_t n) { return (n + 7) & ~(size_t)7; }
+
+SharedRing::SharedRing() : header(NULL), size(0) {}
+
+SharedRing::~SharedRing()
+{
+    // Each process unmaps its own view; the pages go with the last one
+    if (header != NULL)
+        munmap(header, size);
+}
+
+bool SharedRing::create(int procs, int threads, int nVars, uint64_t capacity, bool removeOlder)
+{
+    assert(header == NULL && procs > 0 && threads > 0 && capacity > headerSize);
+    int n = procs * threads;
+    size_t offCursors = align8(sizeof(Header));
+    size_t offActive  = offCursors + n * sizeof(uint64_t);
+    size_t offWords   = align8(offActive + n);
+    size_t offUnits   = offWords + capacity * sizeof(uint32_t);
+    size_t offUnitSet = offUnits + nVars * sizeof(uint32_t);
+    size_t offModel   = offUnitSet + nVars;
+    size = offModel + nVars;
+
+    void* page = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (page == MAP_FAILED)
+        return false;
+    char* base = (char*)page; // Zeroed by mmap
+    header  = new (base) Header();
+    cursors = (uint64_t*)(base + offCursors);
+    active  = base + offActive;
+    words   = (uint32_t*)(base + offWords);
+    units   = (uint32_t*)(base + offUnits);
+    unitSet = base + offUnitSet;
+    model   = base + offModel;
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&header->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    header->procs       = procs;
+    header->threads     = threads;
+    header->nVars       = nVars;
+    header->removeOlder = removeOlder;
+    header->capacity    = capacity;
+    header->head.store(0);
+    header->tail        = 0;
+    header->nbUnits.store(0);
+    header->winner.store(-1);
+    header->winnerThread = -1;
+    header->published.store(false);
+    header->status      = toInt(l_Undef);
+    header->startTime   = realTime();
+    for (int i = 0; i < n; i++)
+        active[i] = 1;
+    return true;
+}
+
+// A process killed while holding the mutex leaves it to the next one (the fifo is only read and
+// written under the mutex, so at worst the clause it was writing is lost)
+void SharedRing::lock()
+{
+    if (pthread_mutex_lock(&header->mutex) == EOWNERDEAD)
+        pthread_mutex_consistent(&header->mutex);
+}
+
+int SharedRing::readersOf(int process)
+{
+    int readers = 0;
+    for (int i = 0; i < header->procs * header->threads; i++)
+        if (active[i] && i / header->threads != process)
+            readers++;
+    return readers;
+}
+
+bool SharedRing::oldestIsWorseThan(Clause& c)
+{
+    uint32_t size = at(header->tail), lbd = at(header->tail + 3);
+    return lbd > (uint32_t)c.lbd() || (lbd == (uint32_t)c.lbd() && size > (uint32_t)c.size());
+}
+
+void SharedRing::dropOldest()
+{
+    assert(header->tail < header->head.load(std::memory_order_relaxed));
+    header->droppedUnread += at(header->tail + 1);
+    header->tail += at(header->tail) + headerSize;
+    header->removed++;
+}
+
+void SharedRing::removeRead()
+{
+    uint64_t head = header->head.load(std::memory_order_relaxed);
+    while (header->tail < head && at(header->tail + 1) == 0) {
+        header->tail += at(header->tail) + headerSize;
+        header->removed++;
+    }
+}
+
+bool SharedRing::pushClause(int thread, Clause& c)
+{
+    uint64_t need = c.size() + headerSize;
+    if (need > header->capacity)
+        return false;
+
+    lock();
+    int readers = readersOf(thread / header->threads);
+    if (readers == 0) { // All the threads of the other processes are paused
+        unlock();
+        return false; }
+    uint64_t head = header->head.load(std::memory_order_relaxed);
+    if (!header->removeOlder) {
+        while (head - header->tail + need > header->capacity && oldestIsWorseThan(c)) {
+            header->evicted++;
+            dropOldest(); }
+        if (head - header->tail + need > header->capacity) {
+            header->rejected++;
+            unlock();
+            return false; } // The old clauses are better
+    }
+    while (head - header->tail + need > header->capacity) {
+        header->forced++;
+        dropOldest(); }
+
+    at(head)     = c.size();
+    at(head + 1) = readers;
+    at(head + 2) = thread;
+    at(head + 3) = c.lbd();
+    for (int i = 0; i < c.size(); i++)
+        at(head + headerSize + i) = toInt(c[i]);
+    header->head.store(head + need, std::memory_order_release);
+    header->pushedClauses++;
+    header->pushedWords += need;
+    unlock();
+    return true;
+}
+
+bool SharedRing::getClause(int thread, vec<Lit>& clause)
+{
+    // Only this thread moves its cursor
+    if (cursors[thread] >= header->head.load(std::memory_order_acquire))
+        return false;
+
+    lock();
+    int process = thread / header->threads;
+    uint64_t head = header->head.load(std::memory_order_relaxed);
+    uint64_t pos = cursors[thread] < header->tail ? header->tail : cursors[thread];
+    while (pos < head && (int)at(pos + 2) / header->threads == process)
+        pos += at(pos) + headerSize;
+    if (pos == head) {
+        cursors[thread] = pos;
+        unlock();
+        return false; }
+
+    uint32_t size = at(pos);
+    bool removeAfter = --at(pos + 1) == 0 && pos == header->tail;
+    clause.clear();
+    for (uint32_t i = 0; i < size; i++)
+        clause.push(toLit(at(pos + headerSize + i)));
+    cursors[thread] = pos + size + headerSize;
+    header->readClauses++;
+    header->readWords += size + headerSize;
+    if (removeAfter)
+        removeRead();
+    unlock();
+    return true;
+}
+
+void SharedRing::pauseReader(int thread)
+{
+    lock();
+    assert(active[thread]);
+    active[thread] = 0;
+    int process = thread / header->threads;
+    uint64_t head = header->head.load(std::memory_order_relaxed);
+    uint64_t pos = cursors[thread] < header->tail ? header->tail : cursors[thread];
+    for (; pos < head; pos += at(pos) + headerSize)
+        if ((int)at(pos + 2) / header->threads != process) {
+            assert(at(pos + 1) > 0);
+            at(pos + 1)--; }
+    cursors[thread] = head;
+    removeRead();
+    unlock();
+}
+
+void SharedRing::resumeReader(int thread)
+{
+    lock();
+    assert(!active[thread]);
+    active[thread] = 1;
+    cursors[thread] = header->head.load(std::memory_order_relaxed);
+    unlock();
+}
+
+void SharedRing::addUnit(Lit p)
+{
+    lock();
+    if (!unitSet[var(p)]) {
+        int n = header->nbUnits.load(std::memory_order_relaxed);
+        unitSet[var(p)] = 1;
+        units[n] = toInt(p);
+        header->nbUnits.store(n + 1, std::memory_order_release);
+    }
+    unlock();
+}
+
+bool SharedRing::claim(int process, int thread)
+{
+    int none = -1;
+    if (!header->winner.compare_exchange_strong(none, process))
+        return false;
+    header->winnerThread = thread;
+    return true;
+}
+
+void SharedRing::publish(lbool status, const vec<lbool>& m)
+{
+    assert(header->winner.load() >= 0);
+    for (int i = 0; i < header->nVars && i < m.size(); i++)
+        model[i] = toInt(m[i]);
+    header->status = toInt(status);
+    header->published.store(true, std::memory_order_release);
+}
+
+lbool SharedRing::status() const
+{
+    return published() ? toLbool(header->status) : l_Undef;
+}
+
+void SharedRing::getModel(vec<lbool>& m) const
+{
+    assert(published());
+    m.clear();
+    for (int i = 0; i < header->nVars; i++)
+        m.push(toLbool(model[i]));
+}
+
+void SharedRing::stats(Stats& s)
+{
+    lock();
+    s.units         = header->nbUnits.load(std::memory_order_relaxed);
+    s.pushedClauses = header->pushedClauses;
+    s.pushedWords   = header->pushedWords;
+    s.readClauses   = header->readClauses;
+    s.readWords     = header->readWords;
+    s.removed       = header->removed;
+    s.evicted       = header->evicted;
+    s.forced        = header->forced;
+    s.rejected      = header->rejected;
+    s.droppedUnread = header->droppedUnread;
+    s.capacity      = header->capacity;
+    s.elapsed       = realTime() - header->startTime;
+    unlock();
+}
@@ -0,0 +1,132 @@
+/***************************************************************************************[SharedRing.h]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_SharedRing_h
+#define Glucose_SharedRing_h
+
+#include <atomic>
+#include <pthread.h>
+#include <stddef.h>
+
+#include "mtl/Vec.h"
+#include "core/SolverTypes.h"
+
+namespace Glucose {
+
+//=================================================================================================
+// Exchange of clauses and units between the solver processes of -procs (see MultiSolvers::solve),
+// in an anonymous shared mapping created before the processes are forked. Each process keeps its
+// own heap, and its threads still share their clauses through its ClausesBuffer first.
+//
+// Clauses: a fifo of uint32_t with the records of ClausesBuffer (size, nseen, origin, lbd, then the
+// literals). Threads are numbered over all the processes (process * threads + thread). A thread
+// reads the clauses of the other processes only, and a clause is removed once all the active
+// threads of the other processes have read it. When the fifo is full, the oldest clauses are
+// removed if they are worse than the new one (LBD, then size), or always with -removeolder;
+// otherwise the new clause is rejected. The fifo does not grow: it is mapped with its maximal size,
+// and its pages are only touched when used.
+//
+// Units: an append-only array of literals, at most one by variable, that each process reads at its
+// own pace (see SharedCompanion::getUnary).
+//
+// Answer: the first process to finish claims it, then publishes its status and model before it
+// exits (see MultiSolvers::endProcesses).
+
+class SharedRing {
+public:
+    SharedRing();
+    ~SharedRing();
+
+    // Maps the region for procs processes of threads threads each, with a fifo of capacity ints.
+    // Returns false if it can not be mapped.
+    bool create(int procs, int threads, int nVars, uint64_t capacity, bool removeOlder);
+
+    // Clauses (thread: over all the processes). getClause is lock free when there is nothing to read.
+    bool pushClause(int thread, Clause& c);
+    bool getClause (int thread, vec<Lit>& clause);
+    void pauseReader (int thread); // Nothing waits for a paused thread; once resumed, it only reads
+    void resumeReader(int thread); // the clauses pushed after
+
+    // Units
+    void addUnit(Lit p);
+    int  nbUnits()    const { return header->nbUnits.load(std::memory_order_acquire); }
+    Lit  unit(int i)  const { return toLit(units[i]); }
+
+    // Answer
+    bool  claim(int process, int thread);                    // True for the first one only
+    bool  answered()      const { return header->winner.load(std::memory_order_acquire) >= 0; }
+    int   winnerProcess() const { return header->winner.load(std::memory_order_acquire); }
+    int   winnerThread()  const { return header->winnerThread; }
+    void  publish(lbool status, const vec<lbool>& model);   // By the winner
+    bool  published()     const { return header->published.load(std::memory_order_acquire); }
+    lbool status()        const;
+    void  getModel(vec<lbool>& model) const;
+
+    struct Stats {
+        int units;
+        uint64_t pushedClauses, pushedWords, readClauses, readWords;
+        uint64_t removed, evicted, forced, rejected, droppedUnread;
+        uint64_t capacity;
+        double elapsed; // Real time since the creation (for the bandwidth)
+    };
+    void stats(Stats& s);
+
+private:
+    static const int headerSize = 4;
+
+    struct Header {
+        pthread_mutex_t       mutex;       // Process shared and robust: a killed process does not hold it
+        int                   procs, threads, nVars;
+        bool                  removeOlder;
+        uint64_t              capacity;
+        std::atomic<uint64_t> head;        // The fifo holds the positions [tail, head) (never wrapped)
+        uint64_t              tail;
+        std::atomic<int>      nbUnits;
+        std::atomic<int>      winner;      // Process, -1 until one finishes
+        int                   winnerThread;
+        std::atomic<bool>     published;
+        int                   status;      // toInt of the lbool, once published
+        double                startTime;
+        uint64_t              pushedClauses, pushedWords, readClauses, readWords;
+        uint64_t              removed, evicted, forced, rejected, droppedUnread;
+    };
+
+    Header*   header;
+    uint64_t* cursors;   // By thread: next position to read
+    char*     active;    // By thread
+    uint32_t* words;     // The fifo
+    uint32_t* units;
+    char*     unitSet;   // By variable
+    char*     model;     // By variable, toInt of the lbool
+    size_t    size;      // Of the mapping
+
+    uint32_t& at(uint64_t pos) { return words[pos % header->capacity]; }
+    void lock();
+    void unlock() { pthread_mutex_unlock(&header->mutex); }
+    int  readersOf(int process);      // Active threads of the other processes
+    bool oldestIsWorseThan(Clause& c);
+    void dropOldest();                // Counting the threads that had not read it
+    void removeRead();                // Removes the oldest clauses read by all
+
+    SharedRing(const SharedRing&);
+    SharedRing& operator=(const SharedRing&);
+};
+
+//=================================================================================================
+}
+
+#endif
@@ -54,78 +54,89 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 using namespace Glucose;
 
-  void SolverConfiguration::configure(MultiSolvers *ms, int nbsolvers) {
-
-   if (nbsolvers < 2 ) return;
-
-   ms->solvers[1]->var_decay = 0.94;
-   ms->solvers[1]->max_var_decay = 0.96;
-   ms->solvers[1]->firstReduceDB=600;
-
-   if (nbsolvers < 3 ) return;
-
-   ms->solvers[2]->var_decay = 0.90;
-   ms->solvers[2]->max_var_decay = 0.97;
-   ms->solvers[2]->firstReduceDB=500;
-
-   if (nbsolvers < 4 ) return;
-
-   ms->solvers[3]->var_decay = 0.85;
-   ms->solvers[3]->max_var_decay = 0.93;
-   ms->solvers[3]->firstReduceDB=400;
-
-   if (nbsolvers < 5 ) return;
-
-   // Glucose 2.0 (+ blocked restarts)
-   ms->solvers[4]->var_decay = 0.95;
-   ms->solvers[4]->max_var_decay = 0.95;
-   ms->solvers[4]->firstReduceDB=4000;
-   ms->solvers[4]->lbdQueue.growTo(100);
-   ms->solvers[4]->sizeLBDQueue = 100;
-   ms->solvers[4]->K = 0.7;
-   ms->solvers[4]->incReduceDB = 500;
-
-   if (nbsolvers < 6 ) return;
-
-   ms->solvers[5]->var_decay = 0.93;
-   ms->solvers[5]->max_var_decay = 0.96;
-   ms->solvers[5]->firstReduceDB=100;
-   ms->solvers[5]->incReduceDB = 500;
-
-   if (nbsolvers < 7 ) return;
-
-   ms->solvers[6]->var_decay = 0.75;
-   ms->solvers[6]->max_var_decay = 0.94;
-   ms->solvers[6]->firstReduceDB=2000;
-
-   if (nbsolvers < 8 ) return; 
-
-   ms->solvers[7]->var_decay = 0.94;
-   ms->solvers[7]->max_var_decay = 0.96;
-   ms->solvers[7]->firstReduceDB=800;
-
-   if (nbsolvers < 9) return;
-
-   ms->solvers[8]->reduceOnSize = true;
-
-   if (nbsolvers < 10 ) return;
+  // Decays and first reduction of the threads 1 to 7 (thread 0 keeps the defaults)
+  void SolverConfiguration::configureDecays(ParallelSolver *s, int k) {
+   static const struct { double var_decay, max_var_decay; int firstReduceDB; } decays[8] = {
+       { 0,    0,    0    },
+       { 0.94, 0.96, 600  },
+       { 0.90, 0.97, 500  },
+       { 0.85, 0.93, 400  },
+       { 0.95, 0.95, 4000 }, // Glucose 2.0 (+ blocked restarts, see below)
+       { 0.93, 0.96, 100  },
+       { 0.75, 0.94, 2000 },
+       { 0.94, 0.96, 800  },
+   };
+   if (k == 0) return;
+   s->var_decay = decays[k].var_decay;
+   s->max_var_decay = decays[k].max_var_decay;
+   s->firstReduceDB = decays[k].firstReduceDB;
+  }
+
+  // Thread i over all the processes (see -procs): the configurations repeat every 8 threads from
+  // thread 10, with some noise, and process 0 is configured as a single process
+  void SolverConfiguration::configureThread(ParallelSolver *s, int i) {
+   if (i < 8) {
+       configureDecays(s, i);
+       if (i == 4) {
+	   s->lbdQueue.growTo(100);
+	   s->sizeLBDQueue = 100;
+	   s->K = 0.7;
+	   s->incReduceDB = 500;
+       } else if (i == 5)
+	   s->incReduceDB = 500;
+       return;
+   }
 
-   ms->solvers[9]->reduceOnSize = true;
-   ms->solvers[9]->reduceOnSizeSize = 14;
+   if (i == 8) {
+       s->reduceOnSize = true;
+       return;
+   }
 
-   if (nbsolvers < 11 ) return;
+   if (i == 9) {
+       s->reduceOnSize = true;
+       s->reduceOnSizeSize = 14;
+       return;
+   }
 
+   // The noise grows by 0.006 and 25 at each group of 8 threads
    double noisevar_decay = 0.005;
    int noiseReduceDB = 50;
-   for (int i=10;i<nbsolvers;i++) {
-       ms->solvers[i]-> var_decay = ms->solvers[i%8]->var_decay;
-       ms->solvers[i]-> max_var_decay = ms->solvers[i%8]->max_var_decay;
-       ms->solvers[i]-> firstReduceDB= ms->solvers[i%8]->firstReduceDB;
-       ms->solvers[i]->var_decay += noisevar_decay;
-       ms->solvers[i]->firstReduceDB+=noiseReduceDB;
-       if ((i+1) % 8 == 0) {
-	   noisevar_decay += 0.006;
-	   noiseReduceDB += 25;
-       }
+   for (int k = 1; k < i / 8; k++) {
+       noisevar_decay += 0.006;
+       noiseReduceDB += 25;
+   }
+   configureDecays(s, i % 8);
+   s->var_decay += noisevar_decay;
+   s->firstReduceDB += noiseReduceDB;
+  }
+
+  void SolverConfiguration::configure(MultiSolvers *ms, int nbsolvers) {
+   for (int i = 0; i < nbsolvers; i++)
+       configureThread(ms->solvers[i], ms->firstThread + i);
+  }
+
+
+  // Diversification of the symmetry handling (when a symmetry file is given), over all the processes.
+  // Thread 0 behaves like the sequential solver.
+  void SolverConfiguration::configureSymmetry(MultiSolvers *ms, int nbsolvers) {
+
+   static const struct { bool sel; bool esbp; cosy::OrderMode order; } modes[] = {
+       { true,  true,  cosy::OrderMode::AUTO      },
+       { true,  false, cosy::OrderMode::AUTO      },
+       { false, true,  cosy::OrderMode::BREAKID   },
+       { true,  true,  cosy::OrderMode::OCCURENCE },
+       { false, false, cosy::OrderMode::AUTO      },
+       { false, true,  cosy::OrderMode::OCCURENCE },
+       { true,  true,  cosy::OrderMode::BREAKID   },
+       { false, true,  cosy::OrderMode::INCREASE  },
+   };
+   const int nbmodes = sizeof(modes) / sizeof(modes[0]);
+
+   for (int i=0;i<nbsolvers;i++) {
+       int m = (ms->firstThread + i) % nbmodes;
+       ms->solvers[i]->useSEL = modes[m].sel;
+       ms->solvers[i]->esbpOrder = modes[m].order;
+       if (modes[m].esbp)
+	   ms->attachSymmetryController(i);
    }
  }
@@ -56,11 +56,17 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 namespace Glucose {
 
 class MultiSolvers;
+class ParallelSolver;
 
 class SolverConfiguration {
 
 public : 
     static void configure(MultiSolvers *ms, int nbsolvers);
+    static void configureSymmetry(MultiSolvers *ms, int nbsolvers);
+
+private :
+    static void configureThread(ParallelSolver *s, int i); // i: over all the processes
+    static void configureDecays(ParallelSolver *s, int k);
     
 };
 
@@ -61,6 +61,7 @@ class ClauseInjector {
         UNITS,
         ESBP,
         ESBP_FORCING,
+        LEX_LEADER,
         NR_TYPES
     };
 
@@ -85,11 +86,13 @@ class ClauseInjector {
         Stats() : StatsGroup("Clause Injector"),
                   units("Number of Units", this),
                   esbp("Number of ESBP", this),
-                  esbp_forcing("Number of ESBP Forcing", this) {}
+                  esbp_forcing("Number of ESBP Forcing", this),
+                  lex_leader("Number of Lex-Leader", this) {}
 
         CounterStat units;
         CounterStat esbp;
         CounterStat esbp_forcing;
+        CounterStat lex_leader;
     };
     Stats _stats;
 
@@ -28,6 +28,15 @@ class CosyManager {
     void summarize() const;
     void printStats() const { _stats.print(); }
 
+    // Inspection of the watch lists
+    bool isWatching(unsigned int status, BooleanVariable variable) const;
+    unsigned int numberOfWatchers(BooleanVariable variable) const {
+        return _watchers[variable.value()].size();
+    }
+    const std::vector<unsigned int>& advanced(BooleanVariable variable) const {
+        return _advanced[variable.value()];
+    }
+
  private:
     const Group& _group;
     const Assignment& _assignment;
@@ -35,15 +44,41 @@ class CosyManager {
 
     std::vector< std::unique_ptr<CosyStatus> > _statuses;
 
+    // A status can only change when the variable of the element or of the
+    // inverse at its lookup index is assigned, so each status watches these
+    // two variables only (slots 0 and 1) and moves its watches with the index.
+    struct Watcher {
+        Watcher(unsigned int st, unsigned int sl) : status(st), slot(sl) {}
+        unsigned int status;
+        unsigned int slot;
+    };
+    struct WatchSlot {
+        WatchSlot() : variable(kNoBooleanVariable), position(0) {}
+        BooleanVariable variable;
+        unsigned int position;  // Index of the watcher in _watchers[variable]
+    };
+    std::vector< std::vector<Watcher> > _watchers;
+    std::vector<WatchSlot> _slots;  // Two slots per status
+    // Statuses whose lookup index moved forward on a variable, to move it
+    // back when the variable is unassigned
+    std::vector< std::vector<unsigned int> > _advanced;
+
+    void watchLookup(unsigned int status);
+    void watch(unsigned int status, unsigned int slot,
+               BooleanVariable variable);
+    void unwatch(unsigned int status, unsigned int slot);
+
     struct Stats : public StatsGroup {
         Stats() : StatsGroup("Cosy Manager"),
                   total_time("Cosy total time", this),
                   notify_time(" |- notify time", this),
-                  cancel_time(" |- cancel time", this)
+                  cancel_time(" |- cancel time", this),
+                  notified("Statuses notified", this)
         {}
         TimeDistribution total_time;
         TimeDistribution notify_time;
         TimeDistribution cancel_time;
+        CounterStat notified;
     };
     Stats _stats;
 
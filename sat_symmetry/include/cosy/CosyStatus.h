@@ -31,11 +31,21 @@ class CosyStatus {
 
     void addLookupLiteral(const Literal& literal);
 
-    void updateNotify(const Literal& literal);
+    // Returns true if the lookup index moved forward on this literal
+    bool updateNotify(const Literal& literal);
     void updateCancel(const Literal& literal);
 
     CosyState state() const { return _state; }
 
+    // The status can only change when the variable of the element or of the
+    // inverse at the lookup index is assigned or unassigned
+    bool isLookupEnd() const { return _lookup_index >= _lookup_order.size(); }
+    Literal lookupElement() const { return _lookup_order[_lookup_index]; }
+    Literal lookupInverse() const {
+        return _permutation.inverseOf(lookupElement());
+    }
+    bool isWatching(BooleanVariable variable) const;
+
     void generateUnitClauseOnInverting(ClauseInjector *injector);
     void generateESBP(BooleanVariable reason, ClauseInjector *injector);
     void generateForceLexLeaderESBP(BooleanVariable reason,
@@ -60,7 +70,6 @@ class CosyStatus {
     std::deque<LookupInfo> _lookup_infos;
     CosyState _state;
 
-    bool isLookupEnd() const { return _lookup_index >= _lookup_order.size(); }
     void updateState();
 
     DISALLOW_COPY_AND_ASSIGN(CosyStatus);
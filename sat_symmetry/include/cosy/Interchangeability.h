@@ -0,0 +1,81 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#ifndef INCLUDE_COSY_INTERCHANGEABILITY_H_
+#define INCLUDE_COSY_INTERCHANGEABILITY_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "cosy/Group.h"
+#include "cosy/Literal.h"
+#include "cosy/Permutation.h"
+#include "cosy/Printer.h"
+#include "cosy/Timer.h"
+
+namespace cosy {
+
+// Recognizes interchangeable rows among the generators of a group, as the
+// "rows ... columns ..." matrices of BreakID: a generator that only swaps two
+// disjoint sequences of literals (the rows) either starts a matrix, or adds a
+// row to the matrix that already contains one of them. Any permutation of the
+// rows of a matrix is a symmetry, so the swaps of all its rows can be given
+// to SEL and ESBP instead of the few generators that built it.
+class Interchangeability {
+ public:
+    typedef std::vector< std::vector<Literal> > Matrix;
+
+    Interchangeability(const Group& group, unsigned int num_vars);
+    ~Interchangeability() {}
+
+    // Returns false if the detection was stopped by the time limit (in
+    // seconds); the matrices found so far are kept.
+    bool detect(double time_limit);
+
+    const std::vector<Matrix>& matrices() const { return _matrices; }
+
+    // Swaps of rows of the matrices that are not already generators of the
+    // group: of all the pairs of rows, or of consecutive rows when linear.
+    void rowSwaps(bool linear,
+                  std::vector< std::unique_ptr<Permutation> > *swaps) const;
+
+    void summarize() const;
+
+ private:
+    struct Position {
+        Position() : matrix(kNone), row(0) {}
+        Position(unsigned int m, unsigned int r) : matrix(m), row(r) {}
+        unsigned int matrix;
+        unsigned int row;
+    };
+    static const unsigned int kNone;
+    static const unsigned int kMinimumRows;
+
+    const Group& _group;
+    const unsigned int _num_vars;
+    std::vector<Matrix> _matrices;
+    // Pairs of rows of each matrix swapped by a generator of the group
+    std::vector< std::vector< std::pair<unsigned int, unsigned int> > > _known;
+    std::vector<Position> _positions;   // Indexed by variable
+    std::vector<bool> _absorbed;        // Indexed by generator
+    std::vector<bool> _marks;           // Indexed by variable
+    bool _completed;
+    Timer _timer;
+
+    bool isRowSwap(const Permutation& permutation) const;
+    bool extend(const Permutation& permutation);
+    bool start(const Permutation& permutation);
+    void addRow(unsigned int matrix, std::vector<Literal>&& row);
+    void addSwap(const Matrix& matrix, unsigned int i, unsigned int j,
+                 std::vector< std::unique_ptr<Permutation> > *swaps) const;
+};
+
+}  // namespace cosy
+
+#endif  // INCLUDE_COSY_INTERCHANGEABILITY_H_
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,56 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#ifndef INCLUDE_COSY_LEXLEADER_H_
+#define INCLUDE_COSY_LEXLEADER_H_
+
+#include <vector>
+
+#include "cosy/ClauseInjector.h"
+#include "cosy/Group.h"
+#include "cosy/Literal.h"
+#include "cosy/Order.h"
+#include "cosy/Permutation.h"
+
+namespace cosy {
+
+// Static symmetry breaking: for each generator g of the group, the
+// assignments that are not smaller than their image by g in the order are
+// forbidden (lex-leader constraint), with the compact encoding of BreakID.
+// The constraint of a generator only covers the first `budget` variables of
+// its support in the order. An auxiliary variable y_i means that the first
+// i variables are equal to their image; auxiliary variables are numbered
+// from the number of variables of the problem.
+class LexLeader {
+ public:
+    LexLeader(const Group& group, const Order& order, unsigned int num_vars);
+    ~LexLeader() {}
+
+    // Adds the clauses to the injector as LEX_LEADER clauses, and returns
+    // the number of auxiliary variables they use.
+    unsigned int generate(unsigned int budget, ClauseInjector *injector);
+
+    unsigned int numberOfClauses() const { return _num_clauses; }
+
+ private:
+    const Group& _group;
+    const Order& _order;
+    const unsigned int _num_vars;
+    unsigned int _num_auxiliaries;
+    unsigned int _num_clauses;
+
+    void generate(const Permutation& permutation, unsigned int budget,
+                  ClauseInjector *injector);
+    Literal newAuxiliary();
+    void addClause(std::vector<Literal>&& literals,
+                   ClauseInjector *injector);
+};
+
+}  // namespace cosy
+
+#endif  // INCLUDE_COSY_LEXLEADER_H_
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
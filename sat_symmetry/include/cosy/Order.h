@@ -4,7 +4,6 @@
 #define INCLUDE_COSY_ORDER_H_
 
 #include <algorithm>
-#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <limits>
@@ -38,9 +37,17 @@ class Order {
     virtual ~Order() {}
 
     unsigned int size() const { return _order.size(); }
-    bool contains(const Literal& literal) const;
+    bool contains(const Literal& literal) const {
+        return _positions[literal.variable().value()] != kNotInOrder;
+    }
 
-    const Literal leq(const Literal& a, const Literal& b) const;
+    const Literal leq(const Literal& a, const Literal& b) const {
+        // <= is really important, on inverting -1, 1 we must return
+        // the positive value because our order is only positive element
+        DCHECK(contains(a) && contains(b));
+        return _positions[a.variable().value()] <=
+            _positions[b.variable().value()] ? a : b;
+    }
     bool isMinimalValue(const Literal& literal,
                         const Assignment& assignment) const;
 
@@ -61,10 +68,14 @@ class Order {
     virtual std::string variableModeString() const = 0;
 
  protected:
+    static const unsigned int kNotInOrder;
+
     const unsigned int _num_vars;
     ValueMode _valueMode;
     std::vector<Literal> _order;
-    std::unordered_map<Literal, unsigned int> _indexes;
+    // Position in _order of each variable (both of its literals share it),
+    // kNotInOrder if the variable is not ordered yet
+    std::vector<unsigned int> _positions;
     LiteralIndex _minimal, _maximal;
 
     void add(const Literal& literal);
@@ -123,7 +134,8 @@ class BreakIDOrder : public Order {
                             const Group& group) :
         Order(num_vars, mode) {
         std::vector<Permutation*> Q, filter;
-        std::unordered_map<BooleanVariable, int64> occurence_generators;
+        std::vector<int64> occurence_generators(num_vars, 0);
+        std::vector<BooleanVariable> occuring;
         Orbits orbits;
         unsigned int largestOrbit;
         BooleanVariable next;
@@ -133,14 +145,18 @@ class BreakIDOrder : public Order {
 
         while (Q.size() > 0) {
             // Compute occurence in remain generators
-            occurence_generators.clear();
+            for (const BooleanVariable& variable : occuring)
+                occurence_generators[variable.value()] = 0;
+            occuring.clear();
             for (const Permutation* permutation : Q) {
-                for (const Literal& literal : permutation->support())
-                    if (literal.isPositive())
-                        occurence_generators[literal.variable()]++;
+                for (const Literal& literal : permutation->support()) {
+                    if (!literal.isPositive())
+                        continue;
+                    const BooleanVariable variable = literal.variable();
+                    if (occurence_generators[variable.value()]++ == 0)
+                        occuring.push_back(variable);
+                }
             }
-            occurence_generators[kNoBooleanVariable] =
-                std::numeric_limits<int>::max();
 
             // Find next variable with less occurences in the largest orbit
             orbits.assign(Q);
@@ -152,10 +168,12 @@ class BreakIDOrder : public Order {
                 if (orbit.size() < largestOrbit)
                     continue;
                 for (const BooleanVariable& variable : orbit) {
-                    if (occurence_generators[variable] == 0)
+                    if (occurence_generators[variable.value()] == 0)
                         continue;
-                    const int occ_v = occurence_generators[variable];
-                    const int occ_n = occurence_generators[next];
+                    const int64 occ_v = occurence_generators[variable.value()];
+                    const int64 occ_n = next == kNoBooleanVariable ?
+                        std::numeric_limits<int64>::max() :
+                        occurence_generators[next.value()];
                     if (next == kNoBooleanVariable ||
                         occ_v < occ_n || (occ_v == occ_n && variable < next)) {
                         next = variable;
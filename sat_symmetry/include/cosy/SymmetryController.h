@@ -13,6 +13,8 @@
 #include "cosy/CNFModel.h"
 #include "cosy/CNFReader.h"
 #include "cosy/Group.h"
+#include "cosy/Interchangeability.h"
+#include "cosy/LexLeader.h"
 #include "cosy/LiteralAdapter.h"
 #include "cosy/Logging.h"
 #include "cosy/OrderFactory.h"
@@ -45,6 +47,22 @@ class SymmetryController {
 
     void enableCosy(OrderMode vars, ValueMode value);
 
+    // Static symmetry breaking instead of ESBP: the lex-leader clauses are
+    // queued as LEX_LEADER clauses. Their auxiliary variables are numbered
+    // from numberOfVariables(); returns how many there are.
+    unsigned int generateLexLeader(OrderMode vars, ValueMode value,
+                                   unsigned int budget);
+    unsigned int numberOfVariables() const { return _num_vars; }
+
+    // Completes the group with the swaps of the rows of the interchangeable
+    // matrices found among its generators within time_limit seconds (see
+    // Interchangeability). To call before enableCosy or generateLexLeader.
+    void detectInterchangeability(double time_limit);
+    // The swaps of rows that were not generators, as (from, to) literals,
+    // for the generators of the solver
+    std::vector<std::pair<std::vector<T>, std::vector<T>>>
+    rowSwaps(bool linear);
+
     void updateNotify(T literal_s, unsigned int level, bool isDecision);
     void updateCancel(T literal_s);
 
@@ -67,6 +85,7 @@ class SymmetryController {
     SymmetryFinder _symmetry_finder;
 
     std::unique_ptr<CosyManager> _cosy_manager;
+    std::unique_ptr<Interchangeability> _interchangeability;
 
     bool loadCNFProblem(const std::string cnf_filename);
     std::vector<T> adaptVector(const std::vector<Literal>& literals);
@@ -98,7 +117,8 @@ inline SymmetryController<T>::SymmetryController(
                            const SymmetryReader reader,
                            const std::unique_ptr<LiteralAdapter<T>>& adapter) :
     _literal_adapter(adapter),
-    _cosy_manager(nullptr) {
+    _cosy_manager(nullptr),
+    _interchangeability(nullptr) {
     bool success;
 
     if (!loadCNFProblem(cnf_filename))
@@ -126,7 +146,8 @@ inline SymmetryController<T>::SymmetryController(
                             SymmetryFinder::Automorphism tool,
                             const std::unique_ptr<LiteralAdapter<T>>& adapter) :
     _literal_adapter(adapter),
-    _cosy_manager(nullptr) {
+    _cosy_manager(nullptr),
+    _interchangeability(nullptr) {
     if (!loadCNFProblem(cnf_filename))
         return;
 
@@ -149,6 +170,51 @@ inline void SymmetryController<T>::enableCosy(OrderMode vars, ValueMode value) {
     _cosy_manager->generateUnits(&_injector);
 }
 
+template<class T> inline unsigned int
+SymmetryController<T>::generateLexLeader(OrderMode vars, ValueMode value,
+                                         unsigned int budget) {
+    if (_group.numberOfPermutations() == 0)
+        return 0;
+
+    std::unique_ptr<Order> order
+        (OrderFactory::create(vars, value, _cnf_model, _group));
+    CHECK_NOTNULL(order);
+
+    LexLeader lex_leader(_group, *order, _num_vars);
+    return lex_leader.generate(budget, &_injector);
+}
+
+template<class T> inline void
+SymmetryController<T>::detectInterchangeability(double time_limit) {
+    _interchangeability = std::unique_ptr<Interchangeability>
+        (new Interchangeability(_group, _num_vars));
+    _interchangeability->detect(time_limit);
+
+    // ESBP uses all the pairs of rows, as for the matrices of BreakID
+    std::vector<std::unique_ptr<Permutation>> swaps;
+    _interchangeability->rowSwaps(false, &swaps);
+    for (std::unique_ptr<Permutation>& swap : swaps)
+        _group.addPermutation(std::move(swap));
+}
+
+template<class T> inline std::vector<std::pair<std::vector<T>, std::vector<T>>>
+SymmetryController<T>::rowSwaps(bool linear) {
+    std::vector<std::pair<std::vector<T>, std::vector<T>>> swaps_s;
+    if (!_interchangeability)
+        return swaps_s;
+
+    std::vector<std::unique_ptr<Permutation>> swaps;
+    _interchangeability->rowSwaps(linear, &swaps);
+    for (const std::unique_ptr<Permutation>& swap : swaps) {
+        std::vector<Literal> images;
+        for (const Literal& literal : swap->support())
+            images.push_back(swap->imageOf(literal));
+        swaps_s.push_back(std::make_pair(adaptVector(swap->support()),
+                                         adaptVector(images)));
+    }
+    return swaps_s;
+}
+
 template<class T>
 inline void SymmetryController<T>::updateNotify(T literal_s,
                                                 unsigned int level,
@@ -227,6 +293,8 @@ SymmetryController<T>::printInfo() const {
     Printer::printSection(" Symmetry Information ");
     _symmetry_finder.printStats();
     _group.summarize(_num_vars);
+    if (_interchangeability)
+        _interchangeability->summarize();
     if (_cosy_manager)
         _cosy_manager->summarize();
 }
@@ -21,6 +21,13 @@ class Timer {
 
     double time() const { return _sum.count(); }
 
+    // Seconds since the last start, without stopping the timer
+    double elapsed() const {
+        const std::chrono::duration<double> e =
+            std::chrono::system_clock::now() - _start;
+        return e.count();
+    }
+
  private:
     std::chrono::time_point<std::chrono::system_clock> _start;
     std::chrono::duration<double> _sum;
@@ -30,6 +30,59 @@ void CosyManager::defineOrder(std::unique_ptr<Order>&& order) {
         for (const unsigned int& index : _group.watch(variable))
             _statuses[index]->addLookupLiteral(literal);
     }
+
+    const unsigned int num_vars = _assignment.numberOfVariables();
+    _watchers.resize(num_vars);
+    _advanced.resize(num_vars);
+    _slots.resize(2 * _statuses.size());
+    for (unsigned int index = 0; index < _statuses.size(); ++index)
+        watchLookup(index);
+}
+
+void CosyManager::watch(unsigned int status, unsigned int slot,
+                        BooleanVariable variable) {
+    WatchSlot& watch_slot = _slots[2 * status + slot];
+    std::vector<Watcher>& watchers = _watchers[variable.value()];
+
+    DCHECK_EQ(watch_slot.variable, kNoBooleanVariable);
+    watch_slot.variable = variable;
+    watch_slot.position = watchers.size();
+    watchers.push_back(Watcher(status, slot));
+}
+
+void CosyManager::unwatch(unsigned int status, unsigned int slot) {
+    WatchSlot& watch_slot = _slots[2 * status + slot];
+    if (watch_slot.variable == kNoBooleanVariable)
+        return;
+
+    std::vector<Watcher>& watchers = _watchers[watch_slot.variable.value()];
+    const Watcher last = watchers.back();
+    watchers[watch_slot.position] = last;
+    _slots[2 * last.status + last.slot].position = watch_slot.position;
+    watchers.pop_back();
+    watch_slot.variable = kNoBooleanVariable;
+}
+
+void CosyManager::watchLookup(unsigned int status) {
+    const std::unique_ptr<CosyStatus>& cosy_status = _statuses[status];
+    BooleanVariable element = kNoBooleanVariable;
+    BooleanVariable inverse = kNoBooleanVariable;
+
+    if (!cosy_status->isLookupEnd()) {
+        element = cosy_status->lookupElement().variable();
+        inverse = cosy_status->lookupInverse().variable();
+        if (inverse == element)  // Inverting position
+            inverse = kNoBooleanVariable;
+    }
+
+    const BooleanVariable targets[2] = { element, inverse };
+    for (unsigned int slot = 0; slot < 2; ++slot) {
+        if (_slots[2 * status + slot].variable == targets[slot])
+            continue;
+        unwatch(status, slot);
+        if (targets[slot] != kNoBooleanVariable)
+            watch(status, slot, targets[slot]);
+    }
 }
 
 void CosyManager::generateUnits(ClauseInjector *injector) {
@@ -43,15 +96,30 @@ void CosyManager::updateNotify(const Literal& literal,
                      time.alsoUpdate(&_stats.notify_time));
 
     const BooleanVariable variable = literal.variable();
-    for (const unsigned int& index : _group.watch(variable)) {
-        const std::unique_ptr<CosyStatus>& status = _statuses[index];
-        if (status->state() != INACTIVE)
-            status->updateNotify(literal);
+    std::vector<Watcher>& watchers = _watchers[variable.value()];
+
+    unsigned int i = 0;
+    while (i < watchers.size()) {
+        const Watcher watcher = watchers[i];
+        const std::unique_ptr<CosyStatus>& status = _statuses[watcher.status];
+
+        if (status->state() != INACTIVE) {
+            IF_STATS_ENABLED(_stats.notified.increment());
+            if (status->updateNotify(literal)) {
+                _advanced[variable.value()].push_back(watcher.status);
+                watchLookup(watcher.status);
+            }
+        }
 
         if (status->state() == REDUCER) {
             status->generateESBP(literal.variable(), injector);
             break;
         }
+
+        // watchLookup may have removed this watcher (swapped with the last)
+        if (i < watchers.size() && watchers[i].status == watcher.status &&
+            watchers[i].slot == watcher.slot)
+            ++i;
     }
 }
 
@@ -60,11 +128,32 @@ void CosyManager::updateCancel(const Literal& literal) {
                      time.alsoUpdate(&_stats.cancel_time));
 
     const BooleanVariable variable = literal.variable();
-    for (const unsigned int& index : _group.watch(variable)) {
-        const std::unique_ptr<CosyStatus>& status = _statuses[index];
+    std::vector<unsigned int>& advanced = _advanced[variable.value()];
+
+    for (const unsigned int& index : advanced) {
+        _statuses[index]->updateCancel(literal);
+        watchLookup(index);
+    }
+    advanced.clear();
+
+    // Statuses stopped on this variable are no more inactive nor reducer
+    for (const Watcher& watcher : _watchers[variable.value()])
+        _statuses[watcher.status]->updateCancel(literal);
+}
 
-        status->updateCancel(literal);
+bool CosyManager::isWatching(unsigned int status,
+                             BooleanVariable variable) const {
+    for (unsigned int slot = 0; slot < 2; ++slot) {
+        const WatchSlot& watch_slot = _slots[2 * status + slot];
+        if (watch_slot.variable != variable)
+            continue;
+        // The slot must point back to its own watcher
+        const std::vector<Watcher>& watchers = _watchers[variable.value()];
+        return watch_slot.position < watchers.size() &&
+            watchers[watch_slot.position].status == status &&
+            watchers[watch_slot.position].slot == slot;
     }
+    return false;
 }
 
 void CosyManager::summarize() const {
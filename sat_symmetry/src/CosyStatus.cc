@@ -39,7 +39,7 @@ void CosyStatus::generateUnitClauseOnInverting(ClauseInjector *injector) {
                         std::move(literals));
 }
 
-void CosyStatus::updateNotify(const Literal& literal) {
+bool CosyStatus::updateNotify(const Literal& literal) {
     unsigned int initial = _lookup_index;
     Literal element, inverse;
     const BooleanVariable variable = literal.variable();
@@ -55,6 +55,7 @@ void CosyStatus::updateNotify(const Literal& literal) {
             _lookup_infos.push_back(LookupInfo(variable, _lookup_index));
     }
     updateState();
+    return _lookup_index != initial;
 }
 
 void CosyStatus::updateCancel(const Literal& literal) {
@@ -71,6 +72,13 @@ void CosyStatus::updateCancel(const Literal& literal) {
     _lookup_infos.pop_back();
 }
 
+bool CosyStatus::isWatching(BooleanVariable variable) const {
+    if (isLookupEnd())
+        return false;
+    return lookupElement().variable() == variable ||
+        lookupInverse().variable() == variable;
+}
+
 void CosyStatus::updateState() {
     Literal element, inverse;
 
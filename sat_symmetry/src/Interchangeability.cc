@@ -0,0 +1,243 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include "cosy/Interchangeability.h"
+
+#include <algorithm>
+
+namespace cosy {
+
+const unsigned int Interchangeability::kNone = -1;
+// Two rows are only the generator itself
+const unsigned int Interchangeability::kMinimumRows = 3;
+
+Interchangeability::Interchangeability(const Group& group,
+                                       unsigned int num_vars) :
+    _group(group),
+    _num_vars(num_vars),
+    _positions(num_vars),
+    _marks(num_vars, false),
+    _completed(true) {
+}
+
+bool Interchangeability::detect(double time_limit) {
+    const std::vector< std::unique_ptr<Permutation> >& generators =
+        _group.permutations();
+    std::vector<unsigned int> candidates;
+
+    _timer.restart();
+    _absorbed.assign(generators.size(), false);
+    for (unsigned int i = 0; i < generators.size(); i++)
+        if (isRowSwap(*generators[i]))
+            candidates.push_back(i);
+
+    // Rows are added to the existing matrices as long as possible before a
+    // new matrix is started, so that a chain of swaps builds one matrix
+    bool progress = true;
+    while (progress && _completed) {
+        progress = false;
+        for (unsigned int i : candidates) {
+            if (_timer.elapsed() > time_limit) {
+                _completed = false;
+                break;
+            }
+            if (!_absorbed[i] && extend(*generators[i]))
+                progress = _absorbed[i] = true;
+        }
+        if (progress || !_completed)
+            continue;
+        for (unsigned int i : candidates) {
+            if (!_absorbed[i] && start(*generators[i])) {
+                progress = _absorbed[i] = true;
+                break;
+            }
+        }
+    }
+
+    unsigned int kept = 0;
+    for (unsigned int m = 0; m < _matrices.size(); m++) {
+        if (_matrices[m].size() < kMinimumRows)
+            continue;
+        if (kept != m) {
+            _matrices[kept] = std::move(_matrices[m]);
+            _known[kept] = std::move(_known[m]);
+        }
+        kept++;
+    }
+    _matrices.resize(kept);
+    _known.resize(kept);
+
+    _timer.stop();
+    return _completed;
+}
+
+bool Interchangeability::isRowSwap(const Permutation& permutation) const {
+    if (permutation.isIdentity())
+        return false;
+
+    for (unsigned int c = 0; c < permutation.numberOfCycles(); c++) {
+        if (permutation.cycle(c).size() != 2)
+            return false;
+        const Literal a = *permutation.cycle(c).begin();
+        const Literal b = permutation.lastElementInCycle(c);
+        if (a.variable() == b.variable())
+            return false;
+        if (!permutation.isTrivialImage(a.negated()) &&
+            permutation.imageOf(a.negated()) != b.negated())
+            return false;
+    }
+    return true;
+}
+
+bool Interchangeability::extend(const Permutation& permutation) {
+    Position position;
+    unsigned int num_vars = 0;
+
+    for (const Literal& literal : permutation.support()) {
+        const int var = literal.variable().value();
+        if (position.matrix == kNone)
+            position = _positions[var];
+        if (!_marks[var]) {
+            _marks[var] = true;
+            num_vars++;
+        }
+    }
+    for (const Literal& literal : permutation.support())
+        _marks[literal.variable().value()] = false;
+
+    if (position.matrix == kNone)
+        return false;
+
+    const std::vector<Literal>& row = _matrices[position.matrix][position.row];
+    if (num_vars != 2 * row.size())
+        return false;
+
+    // Either all the images are in one other row of the matrix, or they
+    // are all new and make a new row
+    std::vector<Literal> images;
+    Position other = Position();
+    for (unsigned int c = 0; c < row.size(); c++) {
+        if (permutation.isTrivialImage(row[c]))
+            return false;
+        const Literal image = permutation.imageOf(row[c]);
+        const Position target = _positions[image.variable().value()];
+        if (c == 0)
+            other = target;
+        if (target.matrix != other.matrix || target.row != other.row)
+            return false;
+        if (target.matrix != kNone &&
+            (target.matrix != position.matrix ||
+             _matrices[target.matrix][target.row][c] != image))
+            return false;
+        images.push_back(image);
+    }
+
+    if (other.matrix == kNone) {
+        const unsigned int index = _matrices[position.matrix].size();
+        _known[position.matrix].push_back(
+            std::make_pair(position.row, index));
+        addRow(position.matrix, std::move(images));
+    } else {
+        _known[position.matrix].push_back(
+            std::make_pair(std::min(position.row, other.row),
+                           std::max(position.row, other.row)));
+    }
+    return true;
+}
+
+bool Interchangeability::start(const Permutation& permutation) {
+    for (const Literal& literal : permutation.support())
+        if (_positions[literal.variable().value()].matrix != kNone)
+            return false;
+
+    // Each swap of variables appears twice, for both signs
+    std::vector<Literal> first, second;
+    for (unsigned int c = 0; c < permutation.numberOfCycles(); c++) {
+        const Literal a = *permutation.cycle(c).begin();
+        const Literal b = permutation.lastElementInCycle(c);
+        if (_marks[a.variable().value()])
+            continue;
+        _marks[a.variable().value()] = _marks[b.variable().value()] = true;
+        first.push_back(a);
+        second.push_back(b);
+    }
+    for (const Literal& literal : permutation.support())
+        _marks[literal.variable().value()] = false;
+
+    _matrices.push_back(Matrix());
+    _known.push_back({ std::make_pair(0u, 1u) });
+    addRow(_matrices.size() - 1, std::move(first));
+    addRow(_matrices.size() - 1, std::move(second));
+    return true;
+}
+
+void Interchangeability::addRow(unsigned int matrix,
+                                std::vector<Literal>&& row) {
+    const unsigned int index = _matrices[matrix].size();
+    for (const Literal& literal : row)
+        _positions[literal.variable().value()] = Position(matrix, index);
+    _matrices[matrix].push_back(std::move(row));
+}
+
+void Interchangeability::rowSwaps(bool linear,
+                    std::vector< std::unique_ptr<Permutation> > *swaps) const {
+    for (unsigned int m = 0; m < _matrices.size(); m++) {
+        const Matrix& matrix = _matrices[m];
+        const unsigned int num_rows = matrix.size();
+        std::vector< std::pair<unsigned int, unsigned int> > pairs;
+
+        if (linear) {
+            for (unsigned int i = 0; i < num_rows; i++) {
+                const unsigned int j = (i + 1) % num_rows;
+                pairs.push_back(std::make_pair(std::min(i, j),
+                                               std::max(i, j)));
+            }
+        } else {
+            for (unsigned int i = 0; i < num_rows; i++)
+                for (unsigned int j = i + 1; j < num_rows; j++)
+                    pairs.push_back(std::make_pair(i, j));
+        }
+
+        for (const std::pair<unsigned int, unsigned int>& pair : pairs) {
+            if (std::find(_known[m].begin(), _known[m].end(), pair) !=
+                _known[m].end())
+                continue;
+            addSwap(matrix, pair.first, pair.second, swaps);
+        }
+    }
+}
+
+void Interchangeability::addSwap(const Matrix& matrix,
+                                 unsigned int i, unsigned int j,
+                    std::vector< std::unique_ptr<Permutation> > *swaps) const {
+    std::unique_ptr<Permutation> swap(new Permutation(_num_vars));
+    for (unsigned int k = 0; k < matrix[i].size(); k++) {
+        swap->addToCurrentCycle(matrix[i][k]);
+        swap->addToCurrentCycle(matrix[j][k]);
+        swap->closeCurrentCycle();
+        swap->addToCurrentCycle(matrix[i][k].negated());
+        swap->addToCurrentCycle(matrix[j][k].negated());
+        swap->closeCurrentCycle();
+    }
+    swaps->push_back(std::move(swap));
+}
+
+void Interchangeability::summarize() const {
+    unsigned int num_rows = 0;
+    for (const Matrix& matrix : _matrices)
+        num_rows += matrix.size();
+
+    Printer::printStat("Number of interchangeable matrices",
+                       _matrices.size());
+    Printer::printStat("Number of interchangeable rows", num_rows);
+    Printer::printStat("Interchangeability time", _timer.time(),
+                       _completed ? "s" : "s (time limit reached)");
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
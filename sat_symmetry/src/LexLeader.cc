@@ -0,0 +1,95 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include "cosy/LexLeader.h"
+
+namespace cosy {
+
+LexLeader::LexLeader(const Group& group, const Order& order,
+                     unsigned int num_vars) :
+    _group(group),
+    _order(order),
+    _num_vars(num_vars),
+    _num_auxiliaries(0),
+    _num_clauses(0) {
+}
+
+unsigned int LexLeader::generate(unsigned int budget,
+                                 ClauseInjector *injector) {
+    for (const std::unique_ptr<Permutation>& permutation :
+             _group.permutations())
+        generate(*permutation, budget, injector);
+
+    return _num_auxiliaries;
+}
+
+void LexLeader::generate(const Permutation& permutation, unsigned int budget,
+                         ClauseInjector *injector) {
+    // Literals of the order are positive: a below is true when x takes its
+    // maximal value, so x <= g(x) is the clause (-a g(a))
+    const bool true_less_false = _order.valueMode() == TRUE_LESS_FALSE;
+    Literal equal(kNoLiteralIndex);      // y_{i-1}, none for the first variable
+    Literal previous(kNoLiteralIndex);   // a of the previous variable
+    Literal previous_image(kNoLiteralIndex);
+    unsigned int constrained = 0;
+
+    for (const Literal& literal : _order) {
+        const Literal a = true_less_false ? literal.negated() : literal;
+        if (permutation.isTrivialImage(a))
+            continue;
+        const Literal b = permutation.imageOf(a);
+
+        // y_{i-2} and previous == its image -> y_{i-1}: only when there is a
+        // variable i to constrain, so that no auxiliary variable is wasted
+        if (previous.index() != kNoLiteralIndex) {
+            const Literal next = newAuxiliary();
+            std::vector<Literal> both_true, both_false;
+            if (equal.index() != kNoLiteralIndex) {
+                both_true.push_back(equal.negated());
+                both_false.push_back(equal.negated());
+            }
+            both_true.push_back(previous.negated());
+            both_true.push_back(next);
+            both_false.push_back(previous_image);
+            both_false.push_back(next);
+            addClause(std::move(both_true), injector);
+            addClause(std::move(both_false), injector);
+            equal = next;
+        }
+
+        // y_{i-1} -> a <= b
+        std::vector<Literal> lex;
+        if (equal.index() != kNoLiteralIndex)
+            lex.push_back(equal.negated());
+        lex.push_back(a.negated());
+        if (b != a.negated())
+            lex.push_back(b);
+        addClause(std::move(lex), injector);
+
+        // A flipped variable can not be equal to its image
+        if (b == a.negated() || ++constrained == budget)
+            break;
+
+        previous = a;
+        previous_image = b;
+    }
+}
+
+Literal LexLeader::newAuxiliary() {
+    return Literal(BooleanVariable(_num_vars + _num_auxiliaries++), true);
+}
+
+void LexLeader::addClause(std::vector<Literal>&& literals,
+                          ClauseInjector *injector) {
+    _num_clauses++;
+    injector->addClause(ClauseInjector::LEX_LEADER, kNoBooleanVariable,
+                        std::move(literals));
+}
+
+}  // namespace cosy
+
+/*
+ * Local Variables:
+ * mode: c++
+ * indent-tabs-mode: nil
+ * End:
+ */
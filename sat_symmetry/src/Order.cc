@@ -4,9 +4,13 @@
 
 namespace cosy {
 
+const unsigned int Order::kNotInOrder =
+    std::numeric_limits<unsigned int>::max();
+
 Order::Order(unsigned int num_vars, ValueMode mode)  :
     _num_vars(num_vars),
-    _valueMode(mode) {
+    _valueMode(mode),
+    _positions(num_vars, kNotInOrder) {
     if (mode == TRUE_LESS_FALSE) {
         _minimal = kTrueLiteralIndex;
         _maximal = kFalseLiteralIndex;
@@ -20,22 +24,10 @@ Order::Order(unsigned int num_vars, ValueMode mode)  :
 
 void Order::add(const Literal& literal) {
     CHECK(!contains(literal));
-    const unsigned int sz = _order.size();
-    _indexes[literal] = sz;
-    _indexes[literal.negated()] = sz;
+    _positions[literal.variable().value()] = _order.size();
     _order.push_back(literal);
 }
 
-bool Order::contains(const Literal& literal) const {
-    return _indexes.find(literal) != _indexes.end();
-}
-
-const Literal Order::leq(const Literal& a, const Literal& b) const {
-    // <= is really important, on inverting -1, 1 we must return
-    // the positive value because our order is only positive element
-    return _indexes.at(a) <= _indexes.at(b) ? a : b;
-}
-
 bool
 Order::isMinimalValue(const Literal& lit, const Assignment& assignment) const {
     return (_minimal == kTrueLiteralIndex && assignment.literalIsTrue(lit)) ||
@@ -0,0 +1,123 @@
+// Copyright 2017 Hakan Metin - LIP6
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "cosy/ClauseInjector.h"
+#include "cosy/CosyManager.h"
+
+namespace cosy {
+
+class CosyManagerTest : public testing::Test {
+ protected:
+    static const int num_vars = 4;
+
+    virtual void SetUp() {
+        // Both permutations look up 1 first: (1 2) (-1 -2) and (1 3) (-1 -3)
+        addPermutation({{1, 2}, {-1, -2}});
+        addPermutation({{1, 3}, {-1, -3}});
+
+        assignment.resize(num_vars);
+
+        manager = std::unique_ptr<CosyManager>
+            (new CosyManager(group, assignment));
+        manager->defineOrder(std::unique_ptr<Order>
+                             (new IncreaseOrder(num_vars, TRUE_LESS_FALSE)));
+    }
+
+    void addPermutation(const std::vector<std::vector<int>>& cycles) {
+        std::unique_ptr<Permutation> permutation(new Permutation(num_vars));
+        for (const std::vector<int>& cycle : cycles) {
+            for (int element : cycle)
+                permutation->addToCurrentCycle(element);
+            permutation->closeCurrentCycle();
+        }
+        group.addPermutation(std::move(permutation));
+    }
+
+    void assign(int literal) {
+        assignment.assignFromTrueLiteral(literal);
+        manager->updateNotify(literal, &injector);
+    }
+
+    void unassign(int literal) {
+        assignment.unassignLiteral(literal);
+        manager->updateCancel(literal);
+    }
+
+    static BooleanVariable var(int literal) {
+        return Literal(literal).variable();
+    }
+
+    Group group;
+    Assignment assignment;
+    ClauseInjector injector;
+    std::unique_ptr<CosyManager> manager;
+};
+
+TEST_F(CosyManagerTest, InitialWatches) {
+    ASSERT_EQ(manager->numberOfWatchers(var(1)), 2);
+    ASSERT_TRUE(manager->isWatching(0, var(1)));
+    ASSERT_TRUE(manager->isWatching(0, var(2)));
+    ASSERT_FALSE(manager->isWatching(0, var(3)));
+    ASSERT_TRUE(manager->isWatching(1, var(1)));
+    ASSERT_TRUE(manager->isWatching(1, var(3)));
+    ASSERT_EQ(manager->numberOfWatchers(var(4)), 0);
+}
+
+TEST_F(CosyManagerTest, NotifyWithoutAdvance) {
+    assign(1);
+    ASSERT_TRUE(manager->advanced(var(1)).empty());
+    ASSERT_EQ(manager->numberOfWatchers(var(1)), 2);
+}
+
+TEST_F(CosyManagerTest, NotifyAdvancesAndCancelRestores) {
+    assign(1);
+    assign(2);
+
+    // The first status reaches the end of its lookup order
+    ASSERT_EQ(manager->advanced(var(2)), std::vector<unsigned int>({0}));
+    ASSERT_FALSE(manager->isWatching(0, var(1)));
+    ASSERT_FALSE(manager->isWatching(0, var(2)));
+    ASSERT_EQ(manager->numberOfWatchers(var(2)), 0);
+
+    // Its watcher on 1 was swapped with the one of the second status
+    ASSERT_EQ(manager->numberOfWatchers(var(1)), 1);
+    ASSERT_TRUE(manager->isWatching(1, var(1)));
+    ASSERT_TRUE(manager->isWatching(1, var(3)));
+
+    unassign(2);
+    ASSERT_TRUE(manager->advanced(var(2)).empty());
+    ASSERT_EQ(manager->numberOfWatchers(var(1)), 2);
+    ASSERT_TRUE(manager->isWatching(0, var(1)));
+    ASSERT_TRUE(manager->isWatching(0, var(2)));
+    ASSERT_TRUE(manager->isWatching(1, var(1)));
+}
+
+TEST_F(CosyManagerTest, SwapRemovalKeepsPositions) {
+    assign(1);
+    assign(2);
+    unassign(2);
+
+    // The watchers on 1 are now in the order: second status, first status
+    assign(3);
+    ASSERT_EQ(manager->advanced(var(3)), std::vector<unsigned int>({1}));
+    ASSERT_FALSE(manager->isWatching(1, var(1)));
+    ASSERT_EQ(manager->numberOfWatchers(var(1)), 1);
+    ASSERT_TRUE(manager->isWatching(0, var(1)));
+
+    // The moved watcher is removed from its new position
+    assign(2);
+    ASSERT_EQ(manager->numberOfWatchers(var(1)), 0);
+    ASSERT_EQ(manager->numberOfWatchers(var(2)), 0);
+
+    unassign(2);
+    unassign(3);
+    ASSERT_EQ(manager->numberOfWatchers(var(1)), 2);
+    ASSERT_TRUE(manager->isWatching(0, var(1)));
+    ASSERT_TRUE(manager->isWatching(1, var(1)));
+    ASSERT_TRUE(manager->isWatching(1, var(3)));
+}
+
+}  // namespace cosy
@@ -84,18 +84,39 @@ TEST_F(CosyStatusTest, DetectReducerNotInOrder) {
     ASSERT_EQ(status->state(), REDUCER);
 }
 
+TEST_F(CosyStatusTest, WatchLookupPosition) {
+    ASSERT_TRUE(status->isWatching(Literal(1).variable()));
+    ASSERT_TRUE(status->isWatching(Literal(2).variable()));
+    ASSERT_FALSE(status->isWatching(Literal(3).variable()));
+
+    assignment.assignFromTrueLiteral(1);
+    ASSERT_FALSE(status->updateNotify(1));
+
+    assignment.assignFromTrueLiteral(2);
+    ASSERT_TRUE(status->updateNotify(2));
+    ASSERT_FALSE(status->isWatching(Literal(1).variable()));
+    ASSERT_TRUE(status->isWatching(Literal(3).variable()));
+    ASSERT_TRUE(status->isWatching(Literal(5).variable()));
+
+    assignment.unassignLiteral(2);
+    status->updateCancel(2);
+    ASSERT_TRUE(status->isWatching(Literal(1).variable()));
+    ASSERT_TRUE(status->isWatching(Literal(2).variable()));
+}
+
+// ESBP does not force the lex-leader: the status waits for both literals of the pair
 TEST_F(CosyStatusTest, DetectForcingMin) {
     assignment.assignFromTrueLiteral(2);
     status->updateNotify(2);
 
-    ASSERT_EQ(status->state(), FORCE_LEX_LEADER);
+    ASSERT_EQ(status->state(), ACTIVE);
 }
 
 TEST_F(CosyStatusTest, DetectForcingMax) {
     assignment.assignFromTrueLiteral(-1);
     status->updateNotify(-1);
 
-    ASSERT_EQ(status->state(), FORCE_LEX_LEADER);
+    ASSERT_EQ(status->state(), ACTIVE);
 }
 
 
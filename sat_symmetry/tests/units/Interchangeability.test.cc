@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "cosy/Group.h"
+#include "cosy/Interchangeability.h"
+#include "cosy/Permutation.h"
+
+namespace cosy {
+
+class InterchangeabilityTest : public testing::Test {
+ protected:
+    static const int num_vars = 8;
+
+    void addPermutation(const std::vector<std::vector<int>>& cycles) {
+        std::unique_ptr<Permutation> permutation(new Permutation(num_vars));
+        for (const std::vector<int>& cycle : cycles) {
+            for (int element : cycle)
+                permutation->addToCurrentCycle(element);
+            permutation->closeCurrentCycle();
+        }
+        group.addPermutation(std::move(permutation));
+    }
+
+    // Swap of the rows {x1 x2} and {y1 y2}, for both signs
+    void addSwap(int x1, int x2, int y1, int y2) {
+        addPermutation({{x1, y1}, {-x1, -y1}, {x2, y2}, {-x2, -y2}});
+    }
+
+    Group group;
+};
+
+TEST_F(InterchangeabilityTest, ChainOfSwaps) {
+    // Rows {1 2} {3 4} {5 6}
+    addSwap(1, 2, 3, 4);
+    addSwap(3, 4, 5, 6);
+
+    Interchangeability interchangeability(group, num_vars);
+    ASSERT_TRUE(interchangeability.detect(10));
+    ASSERT_EQ(interchangeability.matrices().size(), 1);
+
+    const Interchangeability::Matrix& matrix =
+        interchangeability.matrices()[0];
+    ASSERT_EQ(matrix.size(), 3);
+    ASSERT_EQ(matrix[2], std::vector<Literal>({Literal(5), Literal(6)}));
+
+    // Only the swap of the first and the last rows is missing
+    std::vector<std::unique_ptr<Permutation>> swaps;
+    interchangeability.rowSwaps(false, &swaps);
+    ASSERT_EQ(swaps.size(), 1);
+    ASSERT_EQ(swaps[0]->imageOf(Literal(1)), Literal(5));
+    ASSERT_EQ(swaps[0]->imageOf(Literal(-6)), Literal(-2));
+}
+
+TEST_F(InterchangeabilityTest, ColumnsFollowTheImages) {
+    // The second swap maps the columns of {3 4} crosswise: {8 7}
+    addSwap(1, 2, 3, 4);
+    addSwap(3, 4, 8, 7);
+    addSwap(1, 2, 8, 7);
+
+    Interchangeability interchangeability(group, num_vars);
+    ASSERT_TRUE(interchangeability.detect(10));
+    ASSERT_EQ(interchangeability.matrices().size(), 1);
+    ASSERT_EQ(interchangeability.matrices()[0][2],
+              std::vector<Literal>({Literal(8), Literal(7)}));
+
+    std::vector<std::unique_ptr<Permutation>> swaps;
+    interchangeability.rowSwaps(false, &swaps);
+    ASSERT_TRUE(swaps.empty());
+}
+
+TEST_F(InterchangeabilityTest, OnlyRowSwaps) {
+    // A 3-cycle and a swap of two rows are not a matrix of 3 rows
+    addPermutation({{1, 2, 3}, {-1, -2, -3}});
+    addSwap(4, 5, 6, 7);
+
+    Interchangeability interchangeability(group, num_vars);
+    ASSERT_TRUE(interchangeability.detect(10));
+    ASSERT_TRUE(interchangeability.matrices().empty());
+}
+
+}  // namespace cosy
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "cosy/ClauseInjector.h"
+#include "cosy/Group.h"
+#include "cosy/LexLeader.h"
+#include "cosy/Order.h"
+#include "cosy/Permutation.h"
+
+namespace cosy {
+
+class LexLeaderTest : public testing::Test {
+ protected:
+    static const int num_vars = 3;
+
+    void addPermutation(const std::vector<std::vector<int>>& cycles) {
+        std::unique_ptr<Permutation> permutation(new Permutation(num_vars));
+        for (const std::vector<int>& cycle : cycles) {
+            for (int element : cycle)
+                permutation->addToCurrentCycle(element);
+            permutation->closeCurrentCycle();
+        }
+        group.addPermutation(std::move(permutation));
+    }
+
+    std::vector<std::vector<int>> clauses(ClauseInjector *injector) {
+        std::vector<std::vector<int>> result;
+        while (injector->hasClause(ClauseInjector::LEX_LEADER,
+                                   kNoBooleanVariable)) {
+            std::vector<int> clause;
+            for (const Literal& literal :
+                     injector->getClause(ClauseInjector::LEX_LEADER,
+                                         kNoBooleanVariable))
+                clause.push_back(literal.signedValue());
+            result.push_back(clause);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    Group group;
+};
+
+TEST_F(LexLeaderTest, CompactEncoding) {
+    // (1 2) (-1 -2)
+    addPermutation({{1, 2}, {-1, -2}});
+    IncreaseOrder order(num_vars, TRUE_LESS_FALSE);
+    ClauseInjector injector;
+    LexLeader lex_leader(group, order, num_vars);
+
+    // True < False: x1 <= x2 forbids x1 false and x2 true. The auxiliary
+    // variable 4 means x1 == x2, and then x2 <= x1
+    ASSERT_EQ(lex_leader.generate(10, &injector), 1);
+    std::vector<std::vector<int>> expected = {
+        {-4, 2, -1}, {-2, 4}, {1, -2}, {1, 4}
+    };
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(clauses(&injector), expected);
+}
+
+TEST_F(LexLeaderTest, Budget) {
+    addPermutation({{1, 2}, {-1, -2}});
+    IncreaseOrder order(num_vars, TRUE_LESS_FALSE);
+    ClauseInjector injector;
+    LexLeader lex_leader(group, order, num_vars);
+
+    ASSERT_EQ(lex_leader.generate(1, &injector), 0);
+    std::vector<std::vector<int>> expected = {{1, -2}};
+    ASSERT_EQ(clauses(&injector), expected);
+}
+
+TEST_F(LexLeaderTest, FlippedVariable) {
+    // (2 -2): x2 must take its minimal value
+    addPermutation({{2, -2}});
+    IncreaseOrder order(num_vars, TRUE_LESS_FALSE);
+    ClauseInjector injector;
+    LexLeader lex_leader(group, order, num_vars);
+
+    ASSERT_EQ(lex_leader.generate(10, &injector), 0);
+    std::vector<std::vector<int>> expected = {{2}};
+    ASSERT_EQ(clauses(&injector), expected);
+    ASSERT_EQ(lex_leader.numberOfClauses(), 1);
+}
+
+}  // namespace cosy
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "cosy/Group.h"
+#include "cosy/Order.h"
+#include "cosy/Permutation.h"
+
+namespace cosy {
+
+TEST(OrderTest, IncreaseOrderLeq) {
+    const int num_vars = 4;
+    IncreaseOrder order(num_vars, TRUE_LESS_FALSE);
+
+    ASSERT_EQ(order.size(), num_vars);
+    for (int i = 1; i <= num_vars; i++) {
+        ASSERT_TRUE(order.contains(Literal(i)));
+        ASSERT_TRUE(order.contains(Literal(-i)));
+    }
+
+    ASSERT_EQ(order.leq(Literal(1), Literal(3)), Literal(1));
+    ASSERT_EQ(order.leq(Literal(4), Literal(-2)), Literal(-2));
+
+    // Both literals of a variable share the same position: the first
+    // argument is returned
+    ASSERT_EQ(order.leq(Literal(1), Literal(-1)), Literal(1));
+    ASSERT_EQ(order.leq(Literal(-1), Literal(1)), Literal(-1));
+}
+
+TEST(OrderTest, BreakIDOrderIsComplete) {
+    const int num_vars = 5;
+    Group group;
+
+    // (3 4) (-3 -4)
+    std::unique_ptr<Permutation> permutation(new Permutation(num_vars));
+    permutation->addToCurrentCycle(3);
+    permutation->addToCurrentCycle(4);
+    permutation->closeCurrentCycle();
+    permutation->addToCurrentCycle(-3);
+    permutation->addToCurrentCycle(-4);
+    permutation->closeCurrentCycle();
+    group.addPermutation(std::move(permutation));
+
+    BreakIDOrder order(num_vars, TRUE_LESS_FALSE, group);
+
+    // Variables of the generators come first, the others complete the order
+    ASSERT_EQ(order.size(), num_vars);
+    ASSERT_EQ(*order.begin(), Literal(3));
+    for (int i = 1; i <= num_vars; i++)
+        ASSERT_TRUE(order.contains(Literal(i)));
+    ASSERT_EQ(order.leq(Literal(5), Literal(-4)), Literal(-4));
+}
+
+}  // namespace cosy
@@ -60,6 +60,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "utils/Options.h"
 #include "core/Dimacs.h"
 #include "core/GlucoseLiteralAdapter.h"
+#include "core/ModelWriter.h"
 #include "cosy/SymmetryController.h"
 #include "simp/SimpSolver.h"
 
@@ -79,6 +80,7 @@ void printStats(Solver& solver)
     printf("c restarts              : %" PRIu64" (%" PRIu64" conflicts in avg)\n", solver.starts,(solver.starts>0 ?solver.conflicts/solver.starts : 0));
     printf("c blocked restarts      : %" PRIu64" (multiple: %" PRIu64") \n", solver.nbstopsrestarts,solver.nbstopsrestartssame);
     printf("c last block at restart : %" PRIu64"\n",solver.lastblockatrestart);
+    printf("c reused trails         : %" PRIu64" (%" PRIu64" levels kept in avg)\n", solver.nbReusedTrails,(solver.nbReusedTrails>0 ?solver.nbReusedLevels/solver.nbReusedTrails : 0));
     printf("c nb ReduceDB           : %" PRIu64"\n", solver.nbReduceDB);
     printf("c nb removed Clauses    : %" PRIu64"\n",solver.nbRemovedClauses);
     printf("c nb learnts DL2        : %" PRIu64"\n", solver.nbDL2);
@@ -88,12 +90,19 @@ void printStats(Solver& solver)
     printf("c conflicts             : %-12" PRIu64"   (%.0f /sec)\n", solver.conflicts   , solver.conflicts   /cpu_time);
     printf("c symgenconfls          : %-12" PRIu64"   (%.0f /sec)\n", solver.symgenconfls   , solver.symgenconfls/cpu_time);
     printf("c symselconfls          : %-12" PRIu64"   (%.0f /sec)\n", solver.symselconfls   , solver.symselconfls/cpu_time);
+    printf("c symselkept            : %-12" PRIu64"   (lazy SEL reasons used in a conflict)\n", solver.symselkept);
+    printf("c symesbpconfls         : %-12" PRIu64"   (%.0f /sec)\n", solver.symesbpconfls  , solver.symesbpconfls/cpu_time);
+    printf("c symesbpkept           : %-12" PRIu64"   (%4.2f %% of symesbpconfls)\n", solver.symesbpkept,
+           solver.symesbpconfls > 0 ? solver.symesbpkept*100 / (double)solver.symesbpconfls : 0.0);
+    printf("c symesbplits           : %-12" PRIu64"   (%4.2f lits removed per ESBP clause)\n", solver.symesbplits,
+           solver.symesbpconfls > 0 ? solver.symesbplits / (double)solver.symesbpconfls : 0.0);
     printf("c decisions             : %-12" PRIu64"   (%4.2f %% random) (%.0f /sec)\n", solver.decisions, (float)solver.rnd_decisions*100 / (float)solver.decisions, solver.decisions   /cpu_time);
     printf("c propagations          : %-12" PRIu64"   (%.0f /sec)\n", solver.propagations, solver.propagations/cpu_time);
     printf("c symgenprops           : %-12" PRIu64"   (%.0f /sec)\n", solver.symgenprops    , solver.symgenprops /cpu_time);
     printf("c symselprops           : %-12" PRIu64"   (%.0f /sec)\n", solver.symselprops    , solver.symselprops /cpu_time);
     printf("c conflict literals     : %-12" PRIu64"   (%4.2f %% deleted)\n", solver.tot_literals, (solver.max_literals - solver.tot_literals)*100 / (double)solver.max_literals);
-    printf("c nb reduced Clauses    : %" PRIu64"\n",solver.nbReducedClauses);
+    printf("c nb reduced Clauses    : %" PRIu64"   (%.2f lits removed in avg)\n",solver.nbReducedClauses,
+           solver.nbReducedClauses > 0 ? (double)solver.nbReducedLits / solver.nbReducedClauses : 0.0);
     if (mem_used != 0) printf("Memory used           : %.2f MB\n", mem_used);
     printf("c CPU time              : %g s\n", cpu_time);
 
@@ -140,11 +149,17 @@ int main(int argc, char** argv)
         //
         IntOption    verb   ("MAIN", "verb",   "Verbosity level (0=silent, 1=some, 2=more).", 1, IntRange(0, 2));
         BoolOption   mod   ("MAIN", "model",   "show model.", false);
+        StringOption mod_fmt("MAIN", "model-format", "Format of the model, in the result file or shown: text, binary or bitset (see core/ModelWriter.h).", "text");
         IntOption    vv  ("MAIN", "vv",   "Verbosity every vv conflicts", 10000, IntRange(1,INT32_MAX));
         BoolOption   pre    ("MAIN", "pre",    "Completely turn on/off any preprocessing.", true);
         StringOption dimacs ("MAIN", "dimacs", "If given, stop after preprocessing and write the result to this file.");
         IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds.\n", INT32_MAX, IntRange(0, INT32_MAX));
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
+        IntOption    wall_lim("MAIN", "wall-lim","Limit on wall-clock time allowed in seconds, checked by the solver (answers INDETERMINATE).\n", INT32_MAX, IntRange(0, INT32_MAX));
+        IntOption    mem_budget("MAIN", "mem-budget","Limit on memory usage in megabytes, checked by the solver (answers INDETERMINATE, where mem-lim makes the allocations fail).\n", INT32_MAX, IntRange(0, INT32_MAX));
+        Int64Option  conf_lim("MAIN", "conf-lim","Limit on the number of conflicts.\n", INT64_MAX, Int64Range(0, INT64_MAX));
+        Int64Option  prop_lim("MAIN", "prop-lim","Limit on the propagation work, SEL and ESBP included (see Solver::propagationWork).\n", INT64_MAX, Int64Range(0, INT64_MAX));
+        StringOption metrics("MAIN", "metrics","If given, publish live counters of the search in this file (mapped in shared memory, see utils/Metrics.h).");
  //       BoolOption opt_incremental ("MAIN","incremental", "Use incremental SAT solving",false);
 
          BoolOption    opt_certified      (_certified, "certified",    "Certified UNSAT using DRUP format", false);
@@ -154,9 +169,17 @@ int main(int argc, char** argv)
 
          BoolOption    opt_bliss      ("SYM", "bliss",  "Parse sym file in bliss", false);
          BoolOption    opt_breakid    ("SYM", "breakid","PArse sym file in breakid format", false);
+         BoolOption    opt_static_sbp ("SYM", "static-sbp", "Add lex-leader symmetry breaking clauses before search, instead of SEL and ESBP", false);
+         IntOption     opt_sbp_size   ("SYM", "sbp-size", "Number of variables constrained by the lex-leader clauses of each generator", 50, IntRange(1, INT32_MAX));
+         BoolOption    opt_detect_rows("SYM", "detect-rows", "Detect interchangeable rows among the generators, and add the swaps of all their rows", false);
+         DoubleOption  opt_rows_time  ("SYM", "rows-time", "Time limit of the detection of interchangeable rows (in seconds)", 10, DoubleRange(0, true, HUGE_VAL, true));
 
         parseOptions(argc, argv, true);
 
+        ModelWriter::Format model_format;
+        if (!ModelWriter::parseFormat(mod_fmt, model_format))
+            printf("ERROR! Unknown model format: %s\n", (const char*)mod_fmt), exit(1);
+
         SimpSolver  S;
         double      initial_time = cpuTime();
 
@@ -167,6 +190,13 @@ int main(int argc, char** argv)
         S.verbEveryConflicts = vv;
 	S.showModel = mod;
 
+        MetricsFile metrics_file;
+        if (metrics){
+            if (metrics_file.open(metrics, 1))
+                S.metrics = metrics_file.slot(0);
+            else
+                printf("c WARNING! Could not create the metrics file %s, running without it.\n", (const char*)metrics); }
+
         S.certifiedUNSAT = opt_certified;
         if(S.certifiedUNSAT) {
             if(!strcmp(opt_certified_file,"NULL")) {
@@ -205,6 +235,12 @@ int main(int argc, char** argv)
                     printf("c WARNING! Could not set resource limit: Virtual memory.\n");
             } }
 
+        // Budgets checked by the solver itself, which then stops cleanly (see Solver::withinBudget):
+        if (wall_lim   != INT32_MAX) S.setTimeBudget(wall_lim);
+        if (mem_budget != INT32_MAX) S.setMemBudget(mem_budget);
+        if (conf_lim   != INT64_MAX) S.setConfBudget(conf_lim);
+        if (prop_lim   != INT64_MAX) S.setPropBudget(prop_lim);
+
         if (argc == 1)
             printf("c Reading from standard input... Use '--help' for help.\n");
 
@@ -215,6 +251,7 @@ int main(int argc, char** argv)
 
         parse_DIMACS(in, S);
         gzclose(in);
+        const int nbInputVars = S.nVars(); // The model shows these ones, not the lex-leader variables
 
         if (opt_bliss && opt_breakid) {
             std::cout << "Cannot Bliss and BreakID format" << std::endl;
@@ -243,11 +280,24 @@ int main(int argc, char** argv)
             S.symmetry = nullptr;
         }
 
+        if (opt_detect_rows && S.symmetry != nullptr)
+            S.symmetry->detectInterchangeability(opt_rows_time);
+
+        int nbLexLeader = -1;
+        if (opt_static_sbp && S.symmetry != nullptr) {
+            // The formula is not symmetric anymore: neither SEL nor ESBP can be used
+            nbLexLeader = add_LEXLEADER(*S.symmetry, S, S.esbpOrder, opt_sbp_size);
+            S.symmetry = nullptr;
+        }
+
         S.notifyCNFUnits();
 
+        int nbRowSwaps = -1;
         gzFile in_sym = (argc == 1) ? gzdopen(0, "rb") : opt_breakid ? gzopen(symloc.c_str(), "rb") : gzopen(sym_file_bliss.c_str(), "rb");
 
-        if (in_sym!=NULL){
+        if (nbLexLeader >= 0) {
+            if (in_sym != NULL) gzclose(in_sym);
+        } else if (in_sym!=NULL){
             if (opt_breakid) {
                 parse_SYMMETRY(in_sym, S, linear_sym_gens);
                 gzclose(in_sym);
@@ -255,6 +305,8 @@ int main(int argc, char** argv)
                 parse_SYMMETRY_BLISS(in_sym, S);
                 gzclose(in_sym);
             }
+            if (opt_detect_rows && S.symmetry != nullptr)
+                nbRowSwaps = add_ROW_SWAPS(*S.symmetry, S, linear_sym_gens);
 
         }else{
             printf("c Did not find .sym symmetry file. Assuming no symmetry is provided.\n");
@@ -269,7 +321,11 @@ int main(int argc, char** argv)
        if (S.verbosity > 0){
             printf("c |  Number of variables:  %12d                                                                   |\n", S.nVars());
             printf("c |  Number of clauses:    %12d                                                                   |\n", S.nClauses());
-            printf("c |  Number of sym generators: %8d                                                                   |\n", S.nGenerators()); }
+            printf("c |  Number of sym generators: %8d                                                                   |\n", S.nGenerators());
+            if (nbRowSwaps >= 0)
+                printf("c |  Number of row swap generators: %8d                                                              |\n", nbRowSwaps);
+            if (nbLexLeader >= 0)
+                printf("c |  Number of lex-leader clauses: %8d                                                               |\n", nbLexLeader); }
 
         double parsed_time = cpuTime();
         if (S.verbosity > 0){
@@ -294,6 +350,7 @@ int main(int argc, char** argv)
         if (!S.okay()){
             if (S.certifiedUNSAT) fprintf(S.certifiedOutput, "0\n"), fclose(S.certifiedOutput);
             if (res != NULL) fprintf(res, "UNSAT\n"), fclose(res);
+            if (S.metrics != NULL) S.publishMetrics(SolverMetrics::Unsatisfiable);
             if (S.verbosity > 0){
  	        printf("c =========================================================================================================\n");
                printf("Solved by simplification\n");
@@ -323,10 +380,7 @@ int main(int argc, char** argv)
         if (res != NULL){
             if (ret == l_True){
                 printf("SAT\n");
-                for (int i = 0; i < S.nVars(); i++)
-                    if (S.model[i] != l_Undef)
-                        fprintf(res, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
-                fprintf(res, " 0\n");
+                ModelWriter(res).write(S.model, nbInputVars, model_format);
             } else {
 	      if (ret == l_False){
 		fprintf(res, "UNSAT\n");
@@ -334,13 +388,8 @@ int main(int argc, char** argv)
 	    }
             fclose(res);
         } else {
-	  if(S.showModel && ret==l_True) {
-	    printf("v ");
-	    for (int i = 0; i < S.nVars(); i++)
-	      if (S.model[i] != l_Undef)
-		printf("%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
-	    printf(" 0\n");
-	  }
+	  if(S.showModel && ret==l_True)
+	    ModelWriter(stdout).write(S.model, nbInputVars, model_format, "v ");
 
 	}
 
@@ -47,6 +47,8 @@ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
 OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  **************************************************************************************************/
 
+#include <pthread.h>
+
 #include "mtl/Sort.h"
 #include "simp/SimpSolver.h"
 #include "utils/System.h"
@@ -61,11 +63,16 @@ static const char* _cat = "SIMP";
 
 static BoolOption   opt_use_asymm        (_cat, "asymm",        "Shrink clauses by asymmetric branching.", false);
 static BoolOption   opt_use_rcheck       (_cat, "rcheck",       "Check if a clause is already implied. (costly)", false);
+static IntOption    opt_asymm_steps      (_cat, "asymm-steps",  "Propagation steps (visited watchers) of one asymmetric branching or implied clause check.", 10000, IntRange(1, INT32_MAX));
+static DoubleOption opt_asymm_time       (_cat, "asymm-time",   "Seconds of asymmetric branching and implied clause checks in one simplification (0: no limit).", 5, DoubleRange(0, true, HUGE_VAL, false));
 static BoolOption   opt_use_elim         (_cat, "elim",         "Perform variable elimination.", true);
 static IntOption    opt_grow             (_cat, "grow",         "Allow a variable elimination step to grow by a number of clauses.", 0);
 static IntOption    opt_clause_lim       (_cat, "cl-lim",       "Variables are not eliminated if it produces a resolvent with a length above this limit. -1 means no limit", 20,   IntRange(-1, INT32_MAX));
 static IntOption    opt_subsumption_lim  (_cat, "sub-lim",      "Do not check if subsumption against a clause larger than this. -1 means no limit.", 1000, IntRange(-1, INT32_MAX));
 static DoubleOption opt_simp_garbage_frac(_cat, "simp-gc-frac", "The fraction of wasted memory allowed before a garbage collection is triggered during simplification.",  0.5, DoubleRange(0, false, HUGE_VAL, false));
+static IntOption    opt_elim_threads     (_cat, "elim-threads", "Number of threads evaluating the variable eliminations (1: sequential).", 1, IntRange(1, 64));
+static IntOption    opt_elim_batch       (_cat, "elim-batch",   "Number of elimination candidates evaluated together by the threads.", 64, IntRange(1, 65536));
+static IntOption    opt_elim_par_cost    (_cat, "elim-par-cost", "Minimum number of resolutions (positive times negative occurrences) of a candidate for the threads to evaluate it with the next ones.", 64, IntRange(0, INT32_MAX));
 
 
 //=================================================================================================
@@ -80,16 +87,28 @@ SimpSolver::SimpSolver() :
   , simp_garbage_frac  (opt_simp_garbage_frac)
   , use_asymm          (opt_use_asymm)
   , use_rcheck         (opt_use_rcheck)
+  , asymm_steps        (opt_asymm_steps)
+  , asymm_time         (opt_asymm_time)
   , use_elim           (opt_use_elim)
+  , elim_threads       (opt_elim_threads)
+  , elim_batch         (opt_elim_batch)
+  , elim_par_cost      (opt_elim_par_cost)
   , merges             (0)
   , asymm_lits         (0)
+  , asymm_checks       (0)
+  , asymm_cutoffs      (0)
   , eliminated_vars    (0)
+  , elim_jobs          (0)
+  , elim_jobs_used     (0)
+  , elim_jobs_redone   (0)
   , elimorder          (1)
   , use_simplification (true)
   , occurs             (ClauseDeleted(ca))
   , elim_heap          (ElimLt(n_occ))
   , bwdsub_assigns     (0)
   , n_touched          (0)
+  , asymm_deadline     (0)
+  , asymm_stopped      (false)
 {
     vec<Lit> dummy(1,lit_Undef);
     ca.extra_clause_field = true; // NOTE: must happen before allocating the dummy clause below.
@@ -100,6 +119,8 @@ SimpSolver::SimpSolver() :
 
 SimpSolver::~SimpSolver()
 {
+    for (int i = 0; i < elim_jobs_pool.size(); i++)
+        delete elim_jobs_pool[i];
 }
 
 
@@ -111,16 +132,28 @@ SimpSolver::SimpSolver(const SimpSolver &s) : Solver(s)
   , simp_garbage_frac  (s.simp_garbage_frac)
   , use_asymm          (s.use_asymm)
   , use_rcheck         (s.use_rcheck)
+  , asymm_steps        (s.asymm_steps)
+  , asymm_time         (s.asymm_time)
   , use_elim           (s.use_elim)
+  , elim_threads       (s.elim_threads)
+  , elim_batch         (s.elim_batch)
+  , elim_par_cost      (s.elim_par_cost)
   , merges             (s.merges)
   , asymm_lits         (s.asymm_lits)
+  , asymm_checks       (s.asymm_checks)
+  , asymm_cutoffs      (s.asymm_cutoffs)
   , eliminated_vars    (s.eliminated_vars)
+  , elim_jobs          (s.elim_jobs)
+  , elim_jobs_used     (s.elim_jobs_used)
+  , elim_jobs_redone   (s.elim_jobs_redone)
   , elimorder          (s.elimorder)
   , use_simplification (s.use_simplification)
   , occurs             (ClauseDeleted(ca))
   , elim_heap          (ElimLt(n_occ))
   , bwdsub_assigns     (s.bwdsub_assigns)
   , n_touched          (s.n_touched)
+  , asymm_deadline     (s.asymm_deadline)
+  , asymm_stopped      (s.asymm_stopped)
 {
     // TODO: Copy dummy... what is it???
     vec<Lit> dummy(1,lit_Undef);
@@ -138,6 +171,8 @@ SimpSolver::SimpSolver(const SimpSolver &s) : Solver(s)
     s.subsumption_queue.copyTo(subsumption_queue);
     s.frozen.memCopyTo(frozen);
     s.eliminated.memCopyTo(eliminated);
+    elim_pending.growTo(s.elim_pending.size(), -1); // The jobs of the batch are not copied
+    elim_marks.growTo(s.elim_marks.size(), 0);
 
     use_simplification = s.use_simplification;
     bwdsub_assigns = s.bwdsub_assigns;
@@ -153,6 +188,8 @@ Var SimpSolver::newVar(bool sign, bool dvar) {
     Var v = Solver::newVar(sign, dvar);
     frozen    .push((char)false);
     eliminated.push((char)false);
+    elim_pending.push(-1);
+    elim_marks.push(0);
 
     if (use_simplification){
         n_occ     .push(0);
@@ -239,6 +276,7 @@ bool SimpSolver::addClause_(vec<Lit>& ps)
         for (int i = 0; i < c.size(); i++){
             occurs[var(c[i])].push(cr);
             n_occ[toInt(c[i])]++;
+            dropElimJob(var(c[i]));
             touched[var(c[i])] = 1;
             n_touched++;
             if (elim_heap.inHeap(var(c[i])))
@@ -260,6 +298,7 @@ void SimpSolver::removeClause(CRef cr,bool inPurgatory)
             n_occ[toInt(c[i])]--;
             updateElimHeap(var(c[i]));
             occurs.smudge(var(c[i]));
+            dropElimJob(var(c[i]));
         }
 
     Solver::removeClause(cr,inPurgatory);
@@ -293,6 +332,8 @@ bool SimpSolver::strengthenClause(CRef cr, Lit l)
           fprintf(certifiedOutput, "0\n");
         }
 
+        for (int i = 0; i < c.size(); i++)
+            dropElimJob(var(c[i]));
         detachClause(cr, true);
         c.strengthen(l);
         attachClause(cr);
@@ -305,10 +346,23 @@ bool SimpSolver::strengthenClause(CRef cr, Lit l)
 }
 
 
-// Returns FALSE if clause is always satisfied ('out_clause' should not be used).
 bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause)
 {
     merges++;
+    return resolve(_ps, _qs, v, out_clause);
+}
+
+
+bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
+{
+    merges++;
+    return resolve(_ps, _qs, v, size);
+}
+
+
+// Returns FALSE if clause is always satisfied ('out_clause' should not be used).
+bool SimpSolver::resolve(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause)
+{
     out_clause.clear();
 
     bool  ps_smallest = _ps.size() < _qs.size();
@@ -337,10 +391,8 @@ bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& ou
 
 
 // Returns FALSE if clause is always satisfied.
-bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
+bool SimpSolver::resolve(const Clause& _ps, const Clause& _qs, Var v, int& size)
 {
-    merges++;
-
     bool  ps_smallest = _ps.size() < _qs.size();
     const Clause& ps  =  ps_smallest ? _qs : _ps;
     const Clause& qs  =  ps_smallest ? _ps : _qs;
@@ -394,10 +446,44 @@ void SimpSolver::gatherTouchedClauses()
 }
 
 
+// The checks of asymmetric branching and implied clauses are bounded: each one by a number of
+// propagation steps, all those of a simplification by a time (the clock is read every 64 checks).
+bool SimpSolver::asymmBudget()
+{
+    if (asymm_stopped)
+        return false;
+    if (asymm_time > 0){
+        if (asymm_deadline == 0)
+            asymm_deadline = realTime() + asymm_time;
+        else if ((asymm_checks & 63) == 0 && realTime() > asymm_deadline){
+            asymm_stopped = true;
+            return false; }
+    }
+    asymm_checks++;
+    return true;
+}
+
+
+// Propagation of the literals enqueued at level 1 by a check. Returns true on a conflict; running
+// out of steps is no conflict, so the check keeps the clause as it is.
+bool SimpSolver::propagateCheck()
+{
+    int64_t steps = asymm_steps;
+    if (propagateLimited(steps) != CRef_Undef)
+        return true;
+    if (qhead < trail.size())
+        asymm_cutoffs++;
+    return false;
+}
+
+
 bool SimpSolver::implied(const vec<Lit>& c)
 {
     assert(decisionLevel() == 0);
 
+    if (!asymmBudget())
+        return false;
+
     trail_lim.push(trail.size());
     for (int i = 0; i < c.size(); i++)
         if (value(c[i]) == l_True){
@@ -408,7 +494,7 @@ bool SimpSolver::implied(const vec<Lit>& c)
             uncheckedEnqueue(~c[i]);
         }
 
-    bool result = propagate() != CRef_Undef;
+    bool result = propagateCheck();
     cancelUntil(0);
     return result;
 }
@@ -424,8 +510,8 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
 
     while (subsumption_queue.size() > 0 || bwdsub_assigns < trail.size()){
 
-        // Empty subsumption queue and return immediately on user-interrupt:
-        if (asynch_interrupt){
+        // Empty subsumption queue and return immediately on user-interrupt (or at the budget):
+        if (!withinBudget()){
             subsumption_queue.clear();
             bwdsub_assigns = trail.size();
             break; }
@@ -487,7 +573,7 @@ bool SimpSolver::asymm(Var v, CRef cr)
     Clause& c = ca[cr];
     assert(decisionLevel() == 0);
 
-    if (c.mark() || satisfied(c)) return true;
+    if (c.mark() || satisfied(c) || !asymmBudget()) return true;
 
     trail_lim.push(trail.size());
     Lit l = lit_Undef;
@@ -497,7 +583,7 @@ bool SimpSolver::asymm(Var v, CRef cr)
         else
             l = c[i];
 
-    if (propagate() != CRef_Undef){
+    if (propagateCheck()){
         cancelUntil(0);
         asymm_lits++;
         if (!strengthenClause(cr, l))
@@ -515,7 +601,7 @@ bool SimpSolver::asymmVar(Var v)
 
     const vec<CRef>& cls = occurs.lookup(v);
 
-    if (value(v) != l_Undef || cls.size() == 0)
+    if (value(v) != l_Undef || cls.size() == 0 || asymm_stopped)
         return true;
 
     for (int i = 0; i < cls.size(); i++)
@@ -584,6 +670,16 @@ bool SimpSolver::eliminateVar(Var v)
                 (++cnt > cls.size() + grow || (clause_lim != -1 && clause_size > clause_lim)))
                 return true;
 
+    return eliminateVar(v, pos, neg, NULL);
+}
+
+
+// Eliminates v, once accepted: the resolvents are those of the cross product of pos and neg, or the
+// ones computed by a thread (see evaluateElimination).
+bool SimpSolver::eliminateVar(Var v, const vec<CRef>& pos, const vec<CRef>& neg, const ElimJob* job)
+{
+    const vec<CRef>& cls = occurs[v]; // Already cleaned by the lookup of the evaluation
+
     // Delete and store old clauses:
     eliminated[v] = true;
     setDecisionVar(v, false);
@@ -600,15 +696,40 @@ bool SimpSolver::eliminateVar(Var v)
     }
 
 
+    // The clauses of v imply all the resolvents: with rcheck, they are removed before the resolvents
+    // are checked (and the removed clauses can still be read). A proof needs the resolvents before
+    // the deletion of their parents, so they are not checked then.
+    bool rcheck       = use_rcheck;
+    bool remove_first = use_rcheck && !certifiedUNSAT;
+    if (remove_first)
+        for (int i = 0; i < cls.size(); i++)
+            removeClause(cls[i]);
+    else
+        use_rcheck = false;
+
     // Produce clauses in cross product:
     vec<Lit>& resolvent = add_tmp;
-    for (int i = 0; i < pos.size(); i++)
-        for (int j = 0; j < neg.size(); j++)
-            if (merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addClause_(resolvent))
-                return false;
+    bool      resolved  = true;
+    if (job == NULL) {
+        for (int i = 0; resolved && i < pos.size(); i++)
+            for (int j = 0; resolved && j < neg.size(); j++)
+                if (merge(ca[pos[i]], ca[neg[j]], v, resolvent))
+                    resolved = addClause_(resolvent);
+    } else {
+        for (int i = 0, k = 0; resolved && i < job->sizes.size(); i++) {
+            resolvent.clear();
+            for (int j = 0; j < job->sizes[i]; j++)
+                resolvent.push(job->resolvents[k++]);
+            resolved = addClause_(resolvent);
+        }
+    }
+    use_rcheck = rcheck;
+    if (!resolved)
+        return false;
 
-    for (int i = 0; i < cls.size(); i++)
-        removeClause(cls[i]);
+    if (!remove_first)
+        for (int i = 0; i < cls.size(); i++)
+            removeClause(cls[i]);
 
     // Free occurs list for this variable:
     occurs[v].clear(true);
@@ -616,11 +737,134 @@ bool SimpSolver::eliminateVar(Var v)
     // Free watchers lists for this variable, if possible:
     if (watches[ mkLit(v)].size() == 0) watches[ mkLit(v)].clear(true);
     if (watches[~mkLit(v)].size() == 0) watches[~mkLit(v)].clear(true);
+    if (watchesTer[ mkLit(v)].size() == 0) watchesTer[ mkLit(v)].clear(true);
+    if (watchesTer[~mkLit(v)].size() == 0) watchesTer[~mkLit(v)].clear(true);
 
     return backwardSubsumptionCheck();
 }
 
 
+// Parallel resolvent generation: the eliminations of first (just removed from elim_heap) and of the
+// next candidates of the heap that share no clause with the previous ones are evaluated by
+// elim_threads threads, on the clause database of the time. The main loop of eliminate still takes the variables
+// in heap order, and uses an evaluation only if no clause of its variable changed since (see
+// dropElimJob), so that the outcome is the one of the sequential elimination.
+void SimpSolver::evaluateEliminations(Var first)
+{
+    // The slots of the evaluations used or dropped are reused, the pending ones are kept
+    if (elim_jobs_pool.size() == 0)
+        for (int i = 0; i < 4 * elim_batch; i++) {
+            elim_jobs_pool.push(new ElimJob);
+            elim_jobs_pool.last()->v = var_Undef;
+        }
+    vec<int> free_slots;
+    for (int i = 0; i < elim_jobs_pool.size(); i++)
+        if (elim_jobs_pool[i]->v == var_Undef || elim_pending[elim_jobs_pool[i]->v] != i)
+            free_slots.push(i);
+    if (free_slots.size() < elim_batch) { // Mostly evaluations far from the top of the heap
+        free_slots.clear();
+        for (int i = 0; i < elim_jobs_pool.size(); i++) {
+            if (elim_jobs_pool[i]->v != var_Undef && elim_pending[elim_jobs_pool[i]->v] == i)
+                elim_pending[elim_jobs_pool[i]->v] = -1;
+            free_slots.push(i);
+        }
+    }
+
+    // The candidates are taken in the order of the heap, as the main loop will remove them (unless
+    // the eliminations change their costs meanwhile), cheap or not
+    vec<Var> candidates;
+    elim_heap.peekMins(4 * elim_batch, candidates);
+
+    elim_round.clear();
+    for (int c = -1; c < candidates.size() && elim_round.size() < elim_batch; c++) {
+        Var v = c < 0 ? first : candidates[c];
+        if (c >= 0 && (elim_pending[v] >= 0 || frozen[v] || isEliminated(v) || value(v) != l_Undef))
+            continue;
+        if (elim_marks[v])
+            continue;
+        const vec<CRef>& cls = occurs.lookup(v);
+        for (int i = 0; i < cls.size(); i++) {
+            const Clause& cl = ca[cls[i]];
+            for (int j = 0; j < cl.size(); j++)
+                elim_marks[var(cl[j])] = 1;
+        }
+        int slot = free_slots[elim_round.size()];
+        elim_jobs_pool[slot]->v = v;
+        elim_pending[v] = slot;
+        elim_round.push(slot);
+    }
+    for (int r = 0; r < elim_round.size(); r++) {
+        const vec<CRef>& cls = occurs[elim_jobs_pool[elim_round[r]]->v];
+        for (int i = 0; i < cls.size(); i++) {
+            const Clause& cl = ca[cls[i]];
+            for (int j = 0; j < cl.size(); j++)
+                elim_marks[var(cl[j])] = 0;
+        }
+    }
+
+    elim_next_job = 0;
+    int nb_threads = elim_threads < elim_round.size() ? elim_threads : elim_round.size();
+    vec<pthread_t> threads;
+    for (int i = 1; i < nb_threads; i++) {
+        threads.push();
+        if (pthread_create(&threads.last(), NULL, elimWorker, this) != 0)
+            threads.pop(); // The other threads (and this one) do its share
+    }
+    elimWorker(this);
+    for (int i = 0; i < threads.size(); i++)
+        pthread_join(threads[i], NULL);
+
+    elim_jobs += elim_round.size();
+    for (int r = 0; r < elim_round.size(); r++)
+        merges += elim_jobs_pool[elim_round[r]]->merges;
+}
+
+
+void* SimpSolver::elimWorker(void* solver)
+{
+    SimpSolver* s = (SimpSolver*)solver;
+    for (int i; (i = s->elim_next_job++) < s->elim_round.size(); )
+        s->evaluateElimination(*s->elim_jobs_pool[s->elim_round[i]]);
+    return NULL;
+}
+
+
+// Same checks and resolvents as eliminateVar, without any change to the solver: it runs in a thread
+void SimpSolver::evaluateElimination(ElimJob& job)
+{
+    Var v = job.v;
+    const vec<CRef>& cls = occurs[v];
+    job.pos.clear();
+    job.neg.clear();
+    job.resolvents.clear();
+    job.sizes.clear();
+    job.merges = 0;
+    job.accepted = false;
+    for (int i = 0; i < cls.size(); i++)
+        (find(ca[cls[i]], mkLit(v)) ? job.pos : job.neg).push(cls[i]);
+
+    int cnt         = 0;
+    int clause_size = 0;
+    for (int i = 0; i < job.pos.size(); i++)
+        for (int j = 0; j < job.neg.size(); j++, job.merges++)
+            if (resolve(ca[job.pos[i]], ca[job.neg[j]], v, clause_size) &&
+                (++cnt > cls.size() + grow || (clause_lim != -1 && clause_size > clause_lim))) {
+                job.merges++;
+                return; }
+
+    vec<Lit> resolvent;
+    for (int i = 0; i < job.pos.size(); i++)
+        for (int j = 0; j < job.neg.size(); j++)
+            if (resolve(ca[job.pos[i]], ca[job.neg[j]], v, resolvent)) {
+                for (int k = 0; k < resolvent.size(); k++)
+                    job.resolvents.push(resolvent[k]);
+                job.sizes.push(resolvent.size());
+            }
+    job.merges += job.pos.size() * job.neg.size();
+    job.accepted = true;
+}
+
+
 bool SimpSolver::substitute(Var v, Lit x)
 {
     assert(!frozen[v]);
@@ -700,8 +944,8 @@ bool SimpSolver::eliminate(bool turn_off_elim)
             !backwardSubsumptionCheck(true)){
             ok = false; goto cleanup; }
 
-        // Empty elim_heap and return immediately on user-interrupt:
-        if (asynch_interrupt){
+        // Empty elim_heap and return immediately on user-interrupt (or at the budget, see withinBudget):
+        if (!withinBudget()){
             assert(bwdsub_assigns == trail.size());
             assert(subsumption_queue.size() == 0);
             assert(n_touched == 0);
@@ -712,7 +956,7 @@ bool SimpSolver::eliminate(bool turn_off_elim)
         for (int cnt = 0; !elim_heap.empty(); cnt++){
             Var elim = elim_heap.removeMin();
             
-            if (asynch_interrupt) break;
+            if (!withinBudget()) break;
 
             if (isEliminated(elim) || value(elim) != l_Undef) continue;
 
@@ -729,8 +973,22 @@ bool SimpSolver::eliminate(bool turn_off_elim)
 
             // At this point, the variable may have been set by assymetric branching, so check it
             // again. Also, don't eliminate frozen variables:
-            if (use_elim && value(elim) == l_Undef && !frozen[elim] && !eliminateVar(elim)){
-                ok = false; goto cleanup; }
+            if (use_elim && value(elim) == l_Undef && !frozen[elim]) {
+                if (elim_pending[elim] == -2)
+                    elim_jobs_redone++; // Its clauses changed since its evaluation
+                if (elim_threads > 1 && elim_pending[elim] < 0 && ElimLt(n_occ).cost(elim) >= (uint64_t)elim_par_cost)
+                    evaluateEliminations(elim);
+                bool res;
+                if (elim_pending[elim] >= 0) {
+                    const ElimJob& job = *elim_jobs_pool[elim_pending[elim]];
+                    elim_pending[elim] = -1;
+                    elim_jobs_used++;
+                    res = !job.accepted || eliminateVar(elim, job.pos, job.neg, &job);
+                } else
+                    res = eliminateVar(elim);
+                if (!res) {
+                    ok = false; goto cleanup; }
+            }
 
             checkGarbage(simp_garbage_frac);
         }
@@ -760,6 +1018,21 @@ bool SimpSolver::eliminate(bool turn_off_elim)
         checkGarbage();
     }
 
+    for (int i = 0; i < elim_jobs_pool.size(); i++){
+        if (elim_jobs_pool[i]->v != var_Undef && elim_pending[elim_jobs_pool[i]->v] == i)
+            elim_pending[elim_jobs_pool[i]->v] = -1;
+        delete elim_jobs_pool[i];
+    }
+    elim_jobs_pool.clear(true);
+    if (verbosity >= 1 && asymm_checks > 0)
+        printf("c |  Asymmetric branching:   %10d checks,    %10d lits removed, %10d out of steps%s |\n",
+               asymm_checks, asymm_lits, asymm_cutoffs, asymm_stopped ? ", time out" : "          ");
+    asymm_deadline = 0; // The next simplification has its own time
+    asymm_stopped  = false;
+    if (verbosity >= 1 && elim_jobs > 0)
+        printf("c |  Parallel elimination:   %10d evaluated, %10d used, %10d evaluated again                   |\n",
+               elim_jobs, elim_jobs_used, elim_jobs_redone);
+
     if (verbosity >= 0 && elimclauses.size() > 0)
         printf("c |  Eliminated clauses:     %10.2f Mb                                                                |\n", 
                double(elimclauses.size() * sizeof(uint32_t)) / (1024*1024));
@@ -806,6 +1079,17 @@ void SimpSolver::relocAll(ClauseAllocator& to)
     // Temporary clause:
     //
     ca.reloc(bwdsub_tmpunit, to);
+
+    // Evaluated eliminations (only the pending ones: their clauses are alive):
+    //
+    for (int i = 0; i < elim_jobs_pool.size(); i++){
+        ElimJob& job = *elim_jobs_pool[i];
+        if (job.v == var_Undef || elim_pending[job.v] != i) continue;
+        for (int j = 0; j < job.pos.size(); j++)
+            ca.reloc(job.pos[j], to);
+        for (int j = 0; j < job.neg.size(); j++)
+            ca.reloc(job.neg[j], to);
+    }
 }
 
 
@@ -50,6 +50,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Glucose_SimpSolver_h
 #define Glucose_SimpSolver_h
 
+#include <atomic>
+
 #include "mtl/Queue.h"
 #include "core/Solver.h"
 #include "mtl/Clone.h"
@@ -129,12 +131,22 @@ class SimpSolver : public Solver {
 
     bool    use_asymm;         // Shrink clauses by asymmetric branching.
     bool    use_rcheck;        // Check if a clause is already implied. Prett costly, and subsumes subsumptions :)
+    int     asymm_steps;       // Propagation steps (visited watchers) of one asymmetric branching or implied clause check.
+    double  asymm_time;        // Seconds of these checks in one simplification (0: no limit).
     bool    use_elim;          // Perform variable elimination.
+    int     elim_threads;      // Threads evaluating the eliminations of the next candidates (1: sequential).
+    int     elim_batch;        // Candidates evaluated together by the threads (4 times more evaluations are kept).
+    int     elim_par_cost;     // The threads are started for a candidate with at least this number of resolutions (see ElimLt).
     // Statistics:
     //
     int     merges;
     int     asymm_lits;
+    int     asymm_checks;      // Asymmetric branching and implied clause checks,
+    int     asymm_cutoffs;     // stopped by their budget of steps.
     int     eliminated_vars;
+    int     elim_jobs;         // Eliminations evaluated by the threads,
+    int     elim_jobs_used;    // then committed as evaluated,
+    int     elim_jobs_redone;  // or evaluated again since the clauses of the variable changed.
 
  protected:
 
@@ -156,6 +168,16 @@ class SimpSolver : public Solver {
         //     return c_x < c_y || c_x == c_y && x < y; }
     };
 
+    // Elimination of a variable evaluated by a thread, on the clauses of the time (see evaluateEliminations)
+    struct ElimJob {
+        Var       v;
+        bool      accepted;
+        int       merges;
+        vec<CRef> pos, neg;
+        vec<Lit>  resolvents;  // Non tautological resolvents, one after the other, in the order of eliminateVar
+        vec<int>  sizes;       // Of the resolvents
+    };
+
     struct ClauseDeleted {
         const ClauseAllocator& ca;
         explicit ClauseDeleted(const ClauseAllocator& _ca) : ca(_ca) {}
@@ -176,6 +198,13 @@ class SimpSolver : public Solver {
     vec<char>           eliminated;
     int                 bwdsub_assigns;
     int                 n_touched;
+    vec<ElimJob*>       elim_jobs_pool; // Behind pointers, as vec moves its elements with realloc
+    vec<int>            elim_round;    // Jobs of the pool evaluated by the threads
+    vec<int>            elim_pending;  // Indexed by variable: its job in elim_jobs_pool, -1 if none, -2 if its clauses changed since
+    vec<char>           elim_marks;    // Indexed by variable: in a clause of a candidate of the batch
+    std::atomic<int>    elim_next_job;
+    double              asymm_deadline; // Of the checks of the current simplification (0: not started)
+    bool                asymm_stopped;  // The time of the checks is spent
 
     // Temporaries:
     //
@@ -186,12 +215,21 @@ class SimpSolver : public Solver {
     virtual lbool         solve_                   (bool do_simp = true, bool turn_off_simp = false);
     bool          asymm                    (Var v, CRef cr);
     bool          asymmVar                 (Var v);
+    bool          asymmBudget              ();
+    bool          propagateCheck           ();
     void          updateElimHeap           (Var v);
     void          gatherTouchedClauses     ();
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause);
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, int& size);
+    static bool   resolve                  (const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause);
+    static bool   resolve                  (const Clause& _ps, const Clause& _qs, Var v, int& size);
     bool          backwardSubsumptionCheck (bool verbose = false);
     bool          eliminateVar             (Var v);
+    bool          eliminateVar             (Var v, const vec<CRef>& pos, const vec<CRef>& neg, const ElimJob* job);
+    void          evaluateEliminations     (Var first);
+    void          evaluateElimination      (ElimJob& job);
+    void          dropElimJob              (Var v);
+    static void*  elimWorker               (void* solver);
     void          extendModel              ();
 
     void          removeClause             (CRef cr,bool inPurgatory=false);
@@ -207,6 +245,7 @@ class SimpSolver : public Solver {
 
 
 inline bool SimpSolver::isEliminated (Var v) const { return eliminated[v]; }
+inline void SimpSolver::dropElimJob  (Var v) { if (elim_pending[v] >= 0) elim_pending[v] = -2; }
 inline void SimpSolver::updateElimHeap(Var v) {
     assert(use_simplification);
     // if (!frozen[v] && !isEliminated(v) && value(v) == l_Undef)
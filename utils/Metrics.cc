@@ -0,0 +1,78 @@
+/**************************************************************************************[Metrics.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "utils/Metrics.h"
+
+#include <assert.h>
+#include <atomic>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace Glucose;
+
+MetricsFile::MetricsFile() : slots(NULL), nb_slots(0) {}
+
+MetricsFile::~MetricsFile()
+{
+    // The file is kept: its last values (and the final status) stay readable after the run
+    if (slots != NULL)
+        munmap(slots, nb_slots * sizeof(SolverMetrics));
+}
+
+bool MetricsFile::open(const char* path, int n)
+{
+    assert(slots == NULL && n > 0);
+    size_t size = n * sizeof(SolverMetrics);
+
+    int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+    if (ftruncate(fd, size) != 0) {
+        close(fd);
+        return false; }
+    void* page = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (page == MAP_FAILED)
+        return false;
+
+    slots    = (SolverMetrics*)page;
+    nb_slots = n;
+    memset(slots, 0, size);
+    for (int i = 0; i < n; i++) {
+        slots[i].magic   = SolverMetrics::Magic;
+        slots[i].version = SolverMetrics::Version;
+        slots[i].slot    = i;
+        slots[i].status  = SolverMetrics::Running; }
+    return true;
+}
+
+// Seqlock: the fields are written between two increments of the sequence number, so that a reader
+// never mistakes a half written slot for a consistent one.
+void MetricsFile::beginUpdate(SolverMetrics& m)
+{
+    m.sequence = m.sequence + 1;
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void MetricsFile::endUpdate(SolverMetrics& m)
+{
+    m.updates++;
+    std::atomic_thread_fence(std::memory_order_release);
+    m.sequence = m.sequence + 1;
+}
@@ -0,0 +1,108 @@
+/***************************************************************************************[Metrics.h]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_Metrics_h
+#define Glucose_Metrics_h
+
+#include <stddef.h>
+
+#include "mtl/IntTypes.h"
+
+namespace Glucose {
+
+//=================================================================================================
+// Live counters of the solvers, in a file mapped in shared memory, so that a monitoring agent can
+// poll a long run without stopping it. The file is an array of SolverMetrics, one per solver
+// (thread). Each solver only writes its own slot, at restarts and clause database reductions (see
+// Solver::publishMetrics).
+//
+// A reader maps the file read-only and copies a slot while its sequence number is even and
+// unchanged by the copy:
+//
+//     do { s = slot.sequence; <acquire fence>; copy = slot; <acquire fence>; }
+//     while ((s & 1) || s != slot.sequence);
+//
+// All the fields are 8 bytes wide: the layout is the same for every compiler on a given platform.
+
+struct SolverMetrics {
+    enum { Magic = 0x53454c4d, Version = 1 };      // "SELM"
+    enum { Running = 0, Satisfiable = 10, Unsatisfiable = 20, Stopped = 30 };
+
+    uint64_t magic;
+    uint64_t version;
+    volatile uint64_t sequence;     // Odd while the slot is written
+    uint64_t slot;                  // Index of the solver (thread number)
+    uint64_t status;                // Running, or the result of the last call to solve
+    uint64_t updates;
+
+    double   cpu_time;              // Seconds (of the whole process)
+    double   real_time;             // Of the update, in seconds since the epoch
+
+    uint64_t conflicts;
+    uint64_t decisions;
+    uint64_t propagations;
+    uint64_t restarts;
+    uint64_t blocked_restarts;
+    uint64_t reduce_db;
+    uint64_t clauses;               // Original clauses
+    uint64_t learnts;
+    uint64_t learnts_literals;
+    uint64_t root_assigns;          // Variables assigned at level 0
+
+    // In megabytes, refreshed at most once per second (they cost a pass on the watches)
+    double   mem_total;             // Of the whole process
+    double   mem_clauses;           // Clause arena
+    double   mem_watches;           // All the watch lists
+    double   mem_symmetry;          // SEL clauses and watches
+
+    uint64_t symgenprops;
+    uint64_t symgenconfls;
+    uint64_t symselprops;
+    uint64_t symselconfls;
+    uint64_t symselkept;
+    uint64_t symesbpconfls;
+    uint64_t symesbpkept;
+    uint64_t symesbplits;
+};
+
+class MetricsFile {
+public:
+    MetricsFile();
+    ~MetricsFile();
+
+    // Creates (or truncates) the file at path with nb_slots zeroed slots. Returns false if the file
+    // can not be created or mapped; the solvers then run without metrics.
+    bool           open(const char* path, int nb_slots);
+    bool           isOpen()     const { return slots != NULL; }
+    int            nbSlots()    const { return nb_slots; }
+    SolverMetrics* slot(int i)        { return (i >= 0 && i < nb_slots) ? &slots[i] : NULL; }
+
+    static void beginUpdate(SolverMetrics& m);
+    static void endUpdate  (SolverMetrics& m);
+
+private:
+    SolverMetrics* slots;
+    int            nb_slots;
+
+    MetricsFile(const MetricsFile&);
+    MetricsFile& operator=(const MetricsFile&);
+};
+
+//=================================================================================================
+}
+
+#endif